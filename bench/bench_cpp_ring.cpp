@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "easy_ring.hpp"
+#include "easy_tools.h"
+
+/*
+ * C++ templates against the C API, the same pattern runs on
+ * easy_data_ringbuffer and easy::ring (uint32_t samples, one by one and in
+ * batches), easy_ringbuffer and easy::byte_ring (16 bytes chunks) and
+ * easy_pool and easy::pool (alloc then free of a few items). The rings are
+ * kept half full so the transfers wrap at every position, both sides must
+ * compute the same check sum.
+ */
+#define BENCH_ITEMS      1000
+#define BENCH_BYTES      4096
+#define BENCH_LOOPS      (16u * 1024 * 1024)
+#define BENCH_BATCH      16
+#define BENCH_CHUNK      16
+#define BENCH_POOL_ITEMS 64
+#define BENCH_POOL_HOLD  4
+
+struct bench_msg
+{
+    uint64_t data[4];
+};
+
+struct bench_result
+{
+    double mops;
+    uint32_t check;
+};
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+template <typename F>
+static bench_result bench_run(F step)
+{
+    bench_result result = {0, 0};
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < BENCH_LOOPS; i++)
+    {
+        result.check += step(i);
+    }
+    result.mops = BENCH_LOOPS / (bench_now() - start) / 1e6;
+
+    return result;
+}
+
+static void bench_print(const char *name, const bench_result &c, const bench_result &cpp)
+{
+    printf("%-12s %10.2f %10.2f %7.2fx%s\n", name, c.mops, cpp.mops, cpp.mops / c.mops, c.check == cpp.check ? "" : "  (check mismatch)");
+}
+
+static uint32_t bench_c_data_storage[BENCH_ITEMS];
+static uint8_t bench_c_byte_storage[BENCH_BYTES];
+static easy::ring<uint32_t, BENCH_ITEMS> bench_ring;
+static easy::byte_ring<BENCH_BYTES> bench_byte_ring;
+static easy::pool<bench_msg, BENCH_POOL_ITEMS> bench_pool;
+EASY_POOL_DEFINE(bench_c_pool, BENCH_POOL_ITEMS, sizeof(struct bench_msg));
+
+static void bench_item(void)
+{
+    easy_data_ringbuffer_t ringbuf;
+    uint32_t fill[BENCH_ITEMS / 2] = {0};
+
+    easy_data_ringbuffer_init(&ringbuf, BENCH_ITEMS, sizeof(uint32_t), bench_c_data_storage);
+    easy_data_ringbuffer_put_n(&ringbuf, fill, BENCH_ITEMS / 2);
+    bench_result c = bench_run([&](uint32_t i) {
+        uint32_t out = 0;
+        easy_data_ringbuffer_put(&ringbuf, &i);
+        easy_data_ringbuffer_get(&ringbuf, &out);
+        return out;
+    });
+
+    bench_ring.reset();
+    bench_ring.put_n(fill, BENCH_ITEMS / 2);
+    bench_result cpp = bench_run([&](uint32_t i) {
+        uint32_t out = 0;
+        bench_ring.put(i);
+        bench_ring.get(out);
+        return out;
+    });
+
+    bench_print("item", c, cpp);
+}
+
+static void bench_batch(void)
+{
+    easy_data_ringbuffer_t ringbuf;
+    uint32_t fill[BENCH_ITEMS / 2] = {0};
+    uint32_t in[BENCH_BATCH];
+    uint32_t out[BENCH_BATCH];
+
+    for (uint32_t i = 0; i < BENCH_BATCH; i++)
+    {
+        in[i] = i * 7;
+    }
+
+    easy_data_ringbuffer_init(&ringbuf, BENCH_ITEMS, sizeof(uint32_t), bench_c_data_storage);
+    easy_data_ringbuffer_put_n(&ringbuf, fill, BENCH_ITEMS / 2);
+    bench_result c = bench_run([&](uint32_t i) {
+        in[i % BENCH_BATCH] = i;
+        easy_data_ringbuffer_put_n(&ringbuf, in, BENCH_BATCH);
+        easy_data_ringbuffer_get_n(&ringbuf, out, BENCH_BATCH);
+        return out[0] + out[BENCH_BATCH - 1];
+    });
+
+    for (uint32_t i = 0; i < BENCH_BATCH; i++)
+    {
+        in[i] = i * 7;
+    }
+    bench_ring.reset();
+    bench_ring.put_n(fill, BENCH_ITEMS / 2);
+    bench_result cpp = bench_run([&](uint32_t i) {
+        in[i % BENCH_BATCH] = i;
+        bench_ring.put_n(in, BENCH_BATCH);
+        bench_ring.get_n(out, BENCH_BATCH);
+        return out[0] + out[BENCH_BATCH - 1];
+    });
+
+    bench_print("batch 16", c, cpp);
+}
+
+static void bench_bytes(void)
+{
+    easy_ringbuffer_t ringbuf;
+    uint8_t fill[BENCH_BYTES / 2] = {0};
+    uint8_t in[BENCH_CHUNK] = {0};
+    uint8_t out[BENCH_CHUNK];
+
+    // not a power of 2, so both sides use the mirrored indices
+    easy_ringbuffer_init(&ringbuf, BENCH_BYTES - 1, bench_c_byte_storage);
+    easy_ringbuffer_put(&ringbuf, fill, sizeof(fill));
+    bench_result c = bench_run([&](uint32_t i) {
+        in[i % BENCH_CHUNK] = (uint8_t)i;
+        easy_ringbuffer_put(&ringbuf, in, BENCH_CHUNK);
+        easy_ringbuffer_get(&ringbuf, out, BENCH_CHUNK);
+        return (uint32_t)out[0] + out[BENCH_CHUNK - 1];
+    });
+
+    static easy::byte_ring<BENCH_BYTES - 1> byte_ring;
+    memset(in, 0, sizeof(in));
+    byte_ring.put(fill, sizeof(fill));
+    bench_result cpp = bench_run([&](uint32_t i) {
+        in[i % BENCH_CHUNK] = (uint8_t)i;
+        byte_ring.put(in, BENCH_CHUNK);
+        byte_ring.get(out, BENCH_CHUNK);
+        return (uint32_t)out[0] + out[BENCH_CHUNK - 1];
+    });
+
+    bench_print("bytes 16", c, cpp);
+}
+
+static void bench_bytes_pow2(void)
+{
+    easy_ringbuffer_t ringbuf;
+    uint8_t fill[BENCH_BYTES / 2] = {0};
+    uint8_t in[BENCH_CHUNK] = {0};
+    uint8_t out[BENCH_CHUNK];
+
+    easy_ringbuffer_init(&ringbuf, BENCH_BYTES, bench_c_byte_storage);
+    easy_ringbuffer_put(&ringbuf, fill, sizeof(fill));
+    bench_result c = bench_run([&](uint32_t i) {
+        in[i % BENCH_CHUNK] = (uint8_t)i;
+        easy_ringbuffer_put(&ringbuf, in, BENCH_CHUNK);
+        easy_ringbuffer_get(&ringbuf, out, BENCH_CHUNK);
+        return (uint32_t)out[0] + out[BENCH_CHUNK - 1];
+    });
+
+    memset(in, 0, sizeof(in));
+    bench_byte_ring.put(fill, sizeof(fill));
+    bench_result cpp = bench_run([&](uint32_t i) {
+        in[i % BENCH_CHUNK] = (uint8_t)i;
+        bench_byte_ring.put(in, BENCH_CHUNK);
+        bench_byte_ring.get(out, BENCH_CHUNK);
+        return (uint32_t)out[0] + out[BENCH_CHUNK - 1];
+    });
+
+    bench_print("bytes pow2", c, cpp);
+}
+
+static void bench_alloc(void)
+{
+    void *items[BENCH_POOL_HOLD];
+
+    EASY_POOL_INIT(bench_c_pool, BENCH_POOL_ITEMS, sizeof(struct bench_msg));
+    bench_result c = bench_run([&](uint32_t i) {
+        uint32_t got = 0;
+        for (uint32_t j = 0; j < BENCH_POOL_HOLD; j++)
+        {
+            items[j] = easy_pool_hook_alloc(&bench_c_pool, sizeof(struct bench_msg));
+            got += items[j] != NULL;
+        }
+        for (uint32_t j = 0; j < BENCH_POOL_HOLD; j++)
+        {
+            easy_pool_hook_free(&bench_c_pool, items[j], sizeof(struct bench_msg));
+        }
+        return got;
+    });
+
+    bench_result cpp = bench_run([&](uint32_t i) {
+        uint32_t got = 0;
+        for (uint32_t j = 0; j < BENCH_POOL_HOLD; j++)
+        {
+            items[j] = bench_pool.alloc();
+            got += items[j] != NULL;
+        }
+        for (uint32_t j = 0; j < BENCH_POOL_HOLD; j++)
+        {
+            bench_pool.free(static_cast<bench_msg *>(items[j]));
+        }
+        return got;
+    });
+
+    bench_print("pool x4", c, cpp);
+}
+
+int main(void)
+{
+    printf("%u loops, million loops per second\n", BENCH_LOOPS);
+    printf("%-12s %10s %10s %8s\n", "case", "C", "C++", "speedup");
+    bench_item();
+    bench_batch();
+    bench_bytes();
+    bench_bytes_pow2();
+    bench_alloc();
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+/*
+ * easy_data_ringbuffer batch benchmark, a batch of samples is put and got
+ * item by item with put/get, and at once with put_n/get_n. The ringbuffer is
+ * kept half full so the batches wrap at every position.
+ */
+#define BENCH_BUFFER_ITEMS 1024
+#define BENCH_TOTAL_ITEMS  (64u * 1024 * 1024)
+#define BENCH_BATCH_MAX    64
+#define BENCH_ITEM_MAX     16
+
+static uint32_t bench_buffer[BENCH_BUFFER_ITEMS * BENCH_ITEM_MAX / sizeof(uint32_t)];
+static uint32_t bench_data[BENCH_BATCH_MAX * BENCH_ITEM_MAX / sizeof(uint32_t)];
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double bench_run(int use_batch, uint32_t item_size, uint32_t batch)
+{
+    easy_data_ringbuffer_t ringbuf;
+    volatile uint32_t check = 0;
+    uint32_t count = BENCH_TOTAL_ITEMS / batch;
+
+    easy_data_ringbuffer_init(&ringbuf, BENCH_BUFFER_ITEMS, item_size, bench_buffer);
+    easy_data_ringbuffer_put_n(&ringbuf, bench_data, BENCH_BUFFER_ITEMS / 2 - batch / 2);
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (use_batch)
+        {
+            check += easy_data_ringbuffer_put_n(&ringbuf, bench_data, batch);
+            check += easy_data_ringbuffer_get_n(&ringbuf, bench_data, batch);
+            continue;
+        }
+
+        for (uint32_t j = 0; j < batch; j++)
+        {
+            check += easy_data_ringbuffer_put(&ringbuf, (uint8_t *)bench_data + j * item_size);
+        }
+        for (uint32_t j = 0; j < batch; j++)
+        {
+            check += easy_data_ringbuffer_get(&ringbuf, (uint8_t *)bench_data + j * item_size);
+        }
+    }
+    double seconds = bench_now() - start;
+
+    return (double)count * batch / seconds / 1e6;
+}
+
+int main(void)
+{
+    static const uint32_t item_sizes[] = {4, 16};
+    static const uint32_t batches[] = {1, 8, 64};
+
+    printf("%u items ringbuffer, million items put+get per second\n", BENCH_BUFFER_ITEMS);
+    printf("%-6s %-6s %10s %10s %8s\n", "item", "batch", "single", "batch", "speedup");
+    for (uint32_t i = 0; i < EASY_ARRAY_SIZE(item_sizes); i++)
+    {
+        for (uint32_t j = 0; j < EASY_ARRAY_SIZE(batches); j++)
+        {
+            double single = bench_run(0, item_sizes[i], batches[j]);
+            double batch = bench_run(1, item_sizes[i], batches[j]);
+
+            printf("%-6u %-6u %10.2f %10.2f %7.2fx\n", item_sizes[i], batches[j], single, batch, batch / single);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+/*
+ * Heap policy benchmark. The alloc/free trace of a message workload is
+ * recorded through a msg allocator hook, then replayed on a fresh heap with
+ * every policy. Throughput is measured on plain replays, the peak
+ * fragmentation on a replay sampling easy_heap_instance_get_stats.
+ */
+#define BENCH_HEAP_SIZE    0x8000
+#define BENCH_CYCLES       20000
+#define BENCH_TRACE_MAX    (BENCH_CYCLES * 16)
+#define BENCH_LIVE_MAX     1024
+#define BENCH_REPLAYS      20
+#define BENCH_STATS_PERIOD 64
+
+struct bench_trace_op
+{
+    uint32_t size;  // 0 for a free
+    uint32_t index; // the alloc op the block comes from
+};
+
+static struct bench_trace_op bench_trace[BENCH_TRACE_MAX];
+static uint32_t bench_trace_len;
+
+static void *bench_live_ptr[BENCH_LIVE_MAX];
+static uint32_t bench_live_index[BENCH_LIVE_MAX];
+
+static uint32_t bench_heap_buffer[BENCH_HEAP_SIZE / sizeof(uint32_t)];
+static easy_heap_t bench_heap;
+static void *bench_replay_ptr[BENCH_TRACE_MAX];
+
+static uint32_t bench_seed = 1;
+
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245 + 12345;
+    return bench_seed >> 16;
+}
+
+/*
+ * Recording allocator, allocates from bench_heap and logs the operations.
+ */
+static void *bench_record_alloc(void *ctx, uint32_t size)
+{
+    void *ptr = easy_heap_instance_malloc((easy_heap_t *)ctx, size);
+
+    if (ptr == NULL || bench_trace_len >= BENCH_TRACE_MAX)
+    {
+        return ptr;
+    }
+
+    for (int i = 0; i < BENCH_LIVE_MAX; i++)
+    {
+        if (bench_live_ptr[i] == NULL)
+        {
+            bench_live_ptr[i] = ptr;
+            bench_live_index[i] = bench_trace_len;
+            break;
+        }
+    }
+    bench_trace[bench_trace_len].size = size;
+    bench_trace[bench_trace_len].index = bench_trace_len;
+    bench_trace_len++;
+
+    return ptr;
+}
+
+static void bench_record_free(void *ctx, void *ptr, uint32_t size)
+{
+    (void)size;
+
+    for (int i = 0; i < BENCH_LIVE_MAX; i++)
+    {
+        if (bench_live_ptr[i] == ptr)
+        {
+            if (bench_trace_len < BENCH_TRACE_MAX)
+            {
+                bench_trace[bench_trace_len].size = 0;
+                bench_trace[bench_trace_len].index = bench_live_index[i];
+                bench_trace_len++;
+            }
+            bench_live_ptr[i] = NULL;
+            break;
+        }
+    }
+
+    easy_heap_instance_free((easy_heap_t *)ctx, ptr);
+}
+
+static const struct easy_msg_allocator bench_record_allocator = {bench_record_alloc, bench_record_free, &bench_heap};
+
+/*
+ * The workload: a driver task with a burst of short lived small events, a
+ * protocol task which holds larger frames for a few cycles, and a log task
+ * which keeps a backlog of medium messages.
+ */
+static struct easy_task bench_task_driver;
+static struct easy_task bench_task_protocol;
+static struct easy_task bench_task_log;
+static int bench_protocol_hold;
+static int bench_log_hold;
+
+static int bench_task_driver_func(struct easy_msg *msg)
+{
+    (void)msg;
+    return EASY_TASK_HDL_CONSUMED;
+}
+
+static int bench_task_protocol_func(struct easy_msg *msg)
+{
+    (void)msg;
+    if (bench_protocol_hold > 0)
+    {
+        bench_protocol_hold--;
+        return EASY_TASK_HDL_SAVED;
+    }
+    bench_protocol_hold = bench_rand() % 4;
+    return EASY_TASK_HDL_CONSUMED;
+}
+
+static int bench_task_log_func(struct easy_msg *msg)
+{
+    (void)msg;
+    if (bench_log_hold > 0)
+    {
+        bench_log_hold--;
+        return EASY_TASK_HDL_SAVED;
+    }
+    bench_log_hold = bench_rand() % 4;
+    return EASY_TASK_HDL_CONSUMED;
+}
+
+static void bench_record(void)
+{
+    easy_heap_instance_init(&bench_heap, bench_heap_buffer, sizeof(bench_heap_buffer));
+
+    bench_task_driver.func = bench_task_driver_func;
+    bench_task_protocol.func = bench_task_protocol_func;
+    bench_task_log.func = bench_task_log_func;
+    easy_task_create(&bench_task_driver);
+    easy_task_create(&bench_task_protocol);
+    easy_task_create(&bench_task_log);
+    easy_task_set_allocator(&bench_task_driver, &bench_record_allocator);
+    easy_task_set_allocator(&bench_task_protocol, &bench_record_allocator);
+    easy_task_set_allocator(&bench_task_log, &bench_record_allocator);
+
+    for (int cycle = 0; cycle < BENCH_CYCLES; cycle++)
+    {
+        int burst = 1 + bench_rand() % 6;
+        for (int i = 0; i < burst; i++)
+        {
+            easy_task_send_msg(&bench_task_driver, easy_task_msg_alloc_len(&bench_task_driver, 1, 4 + bench_rand() % 28));
+        }
+        if (bench_rand() % 3 == 0)
+        {
+            easy_task_send_msg(&bench_task_protocol, easy_task_msg_alloc_len(&bench_task_protocol, 2, 64 + bench_rand() % 448));
+        }
+        if (bench_rand() % 4 == 0)
+        {
+            easy_task_send_msg(&bench_task_log, easy_task_msg_alloc_len(&bench_task_log, 3, 16 + bench_rand() % 112));
+        }
+        easy_task_polling();
+    }
+
+    // drain the saved messages
+    bench_protocol_hold = bench_log_hold = 0;
+    while (!easy_task_check_empty())
+    {
+        bench_protocol_hold = bench_log_hold = 0;
+        easy_task_polling();
+    }
+
+    easy_task_delete(&bench_task_driver);
+    easy_task_delete(&bench_task_protocol);
+    easy_task_delete(&bench_task_log);
+}
+
+/*
+ * Replays the trace, returns the failed allocations. The peak fragmentation
+ * is sampled if peak_fragmentation is not NULL.
+ */
+static uint32_t bench_replay(easy_heap_policy_t policy, uint32_t *peak_fragmentation)
+{
+    easy_heap_stats_t stats;
+    uint32_t failed = 0;
+
+    easy_heap_instance_init(&bench_heap, bench_heap_buffer, sizeof(bench_heap_buffer));
+    easy_heap_instance_set_policy(&bench_heap, policy);
+
+    for (uint32_t i = 0; i < bench_trace_len; i++)
+    {
+        if (bench_trace[i].size != 0)
+        {
+            bench_replay_ptr[i] = easy_heap_instance_malloc(&bench_heap, bench_trace[i].size);
+            failed += (bench_replay_ptr[i] == NULL);
+        }
+        else
+        {
+            easy_heap_instance_free(&bench_heap, bench_replay_ptr[bench_trace[i].index]);
+        }
+
+        if (peak_fragmentation != NULL && (i % BENCH_STATS_PERIOD) == 0)
+        {
+            easy_heap_instance_get_stats(&bench_heap, &stats);
+            if (stats.xFragmentation > *peak_fragmentation)
+            {
+                *peak_fragmentation = stats.xFragmentation;
+            }
+        }
+    }
+
+    return failed;
+}
+
+int main(void)
+{
+    static const char *names[] = {"first-fit", "next-fit", "best-fit"};
+
+    easy_tools_init();
+    bench_record();
+    printf("trace of %u ops, heap 0x%x bytes\n", bench_trace_len, BENCH_HEAP_SIZE);
+
+    for (int policy = EASY_HEAP_POLICY_FIRST_FIT; policy <= EASY_HEAP_POLICY_BEST_FIT; policy++)
+    {
+        uint32_t peak_fragmentation = 0;
+        uint32_t failed = bench_replay((easy_heap_policy_t)policy, &peak_fragmentation);
+
+        clock_t start = clock();
+        for (int i = 0; i < BENCH_REPLAYS; i++)
+        {
+            bench_replay((easy_heap_policy_t)policy, NULL);
+        }
+        clock_t end = clock();
+
+        double ns = (double)(end - start) * 1e9 / CLOCKS_PER_SEC / ((double)bench_trace_len * BENCH_REPLAYS);
+        printf("%-10s %6.1f ns/op  peak fragmentation %4u/1000  failed %u\n", names[policy], ns, peak_fragmentation, failed);
+    }
+
+    return 0;
+}
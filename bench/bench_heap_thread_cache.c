@@ -0,0 +1,182 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime, sysconf */
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "easy_tools.h"
+
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+/*
+ * Heap thread cache scaling, every thread keeps a window of live blocks and
+ * replaces the oldest one with a new block of a random size, a part of the
+ * blocks is handed to the next thread which frees them. The thread count goes
+ * from 1 to the number of cores, the per-thread caches are compared with all
+ * the threads sharing one heap instance under a mutex (what the threads
+ * beyond EASY_CONFIG_HEAP_THREAD_CACHE_MAX get).
+ */
+#define BENCH_OPS         (2u * 1024 * 1024)
+#define BENCH_WINDOW      64
+#define BENCH_SIZE_MAX    256
+#define BENCH_HANDOFF     16 /* One block out of BENCH_HANDOFF is freed by the next thread */
+#define BENCH_THREADS_MAX (EASY_CONFIG_HEAP_THREAD_CACHE_MAX - 1)
+
+struct bench_thread
+{
+    pthread_t thread;
+    uint32_t index;
+    uint32_t failed;
+    easy_spsc_ringbuffer_t handoff; /* Blocks the previous thread gives to this one */
+    uint8_t handoff_buffer[BENCH_WINDOW * sizeof(void *)];
+};
+
+static uint32_t bench_heap_buf[(2 * EASY_CONFIG_HEAP_THREAD_CACHE_SIZE * EASY_CONFIG_HEAP_THREAD_CACHE_MAX + 0x10000) / sizeof(uint32_t)];
+static uint32_t bench_shared_buf[(EASY_CONFIG_HEAP_THREAD_CACHE_SIZE * EASY_CONFIG_HEAP_THREAD_CACHE_MAX) / sizeof(uint32_t)];
+static easy_heap_t bench_shared;
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct bench_thread bench_threads[BENCH_THREADS_MAX];
+static uint32_t bench_thread_count;
+static int bench_use_lock;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *bench_malloc(uint32_t size)
+{
+    void *ptr;
+
+    if (!bench_use_lock)
+    {
+        return easy_heap_malloc(size);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    ptr = easy_heap_instance_malloc(&bench_shared, size);
+    pthread_mutex_unlock(&bench_lock);
+    return ptr;
+}
+
+static void bench_free(void *ptr)
+{
+    if (!bench_use_lock)
+    {
+        easy_heap_free(ptr);
+        return;
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    easy_heap_instance_free(&bench_shared, ptr);
+    pthread_mutex_unlock(&bench_lock);
+}
+
+static void *bench_worker(void *arg)
+{
+    struct bench_thread *self = arg;
+    struct bench_thread *next = &bench_threads[(self->index + 1) % bench_thread_count];
+    void *window[BENCH_WINDOW] = {0};
+    uint32_t seed = self->index * 7919 + 1;
+    void *ptr;
+
+    for (uint32_t i = 0; i < BENCH_OPS; i++)
+    {
+        uint32_t slot = i % BENCH_WINDOW;
+
+        seed = seed * 1103515245 + 12345;
+        if (window[slot] != NULL)
+        {
+            /* hand it over, or free it here when the next thread lags behind */
+            if (bench_thread_count == 1 || (seed >> 4) % BENCH_HANDOFF != 0 || easy_spsc_ringbuffer_put(&next->handoff, (uint8_t *)&window[slot], sizeof(void *)) == 0)
+            {
+                bench_free(window[slot]);
+            }
+        }
+        while (easy_spsc_ringbuffer_get(&self->handoff, (uint8_t *)&ptr, sizeof(void *)) == sizeof(void *))
+        {
+            bench_free(ptr);
+        }
+
+        window[slot] = bench_malloc(16 + (seed >> 16) % (BENCH_SIZE_MAX - 16));
+        self->failed += window[slot] == NULL;
+    }
+
+    for (uint32_t i = 0; i < BENCH_WINDOW; i++)
+    {
+        bench_free(window[i]);
+    }
+
+    return NULL;
+}
+
+static void bench_run(const char *name, int use_lock, uint32_t threads)
+{
+    uint32_t failed = 0;
+    void *ptr;
+
+    bench_use_lock = use_lock;
+    bench_thread_count = threads;
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        bench_threads[i].index = i;
+        bench_threads[i].failed = 0;
+        easy_spsc_ringbuffer_init(&bench_threads[i].handoff, sizeof(bench_threads[i].handoff_buffer), bench_threads[i].handoff_buffer);
+    }
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        pthread_create(&bench_threads[i].thread, NULL, bench_worker, &bench_threads[i]);
+    }
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        pthread_join(bench_threads[i].thread, NULL);
+    }
+    double seconds = bench_now() - start;
+
+    /* blocks handed over after the next thread finished */
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        while (easy_spsc_ringbuffer_get(&bench_threads[i].handoff, (uint8_t *)&ptr, sizeof(void *)) == sizeof(void *))
+        {
+            bench_free(ptr);
+        }
+        failed += bench_threads[i].failed;
+    }
+
+    int empty = use_lock ? easy_heap_instance_check_empty(&bench_shared) : easy_heap_check_empty();
+    printf("%-8s %2u %12.2f%s%s\n", name, threads, (double)BENCH_OPS * threads / seconds / 1e6, failed ? "  (malloc failed)" : "", empty ? "" : "  (leak)");
+}
+
+int main(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads_max = (uint32_t)EASY_MIN(EASY_MAX(cores, 2), BENCH_THREADS_MAX);
+
+    easy_heap_init(bench_heap_buf, sizeof(bench_heap_buf));
+    easy_heap_instance_init(&bench_shared, bench_shared_buf, sizeof(bench_shared_buf));
+
+    printf("%u malloc+free per thread, %ld cores, million malloc+free per second\n", BENCH_OPS, cores);
+    for (uint32_t threads = 1; threads <= threads_max; threads = (threads < threads_max && threads * 2 > threads_max) ? threads_max : threads * 2)
+    {
+        bench_run("cache", 0, threads);
+        bench_run("mutex", 1, threads);
+    }
+
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("bench_heap_thread_cache needs EASY_CONFIG_HEAP_THREAD_CACHE\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,218 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime, sysconf */
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "easy_tools.h"
+
+/*
+ * MPMC ringbuffer benchmark, P producers send BENCH_TOTAL_ITEMS time stamped
+ * items to C consumers, with P = C going from 1 to the number of cores. The
+ * lock-free easy_mpmc_ringbuffer is compared with easy_data_ringbuffer
+ * protected by a mutex. The latency is the time from put to get, kept in a
+ * log-linear histogram per consumer (8 buckets per power of 2).
+ */
+#define BENCH_BUFFER_SIZE  1024
+#define BENCH_TOTAL_ITEMS  (2u * 1024 * 1024)
+#define BENCH_THREADS_MAX  64
+#define BENCH_HIST_BUCKETS 512
+
+struct bench_item
+{
+    uint64_t stamp;
+    uint32_t seq;
+    uint32_t producer;
+};
+
+struct bench_consumer
+{
+    pthread_t thread;
+    uint64_t hist[BENCH_HIST_BUCKETS];
+    uint64_t seq_sum;
+    uint32_t received;
+};
+
+EASY_MPMC_RINGBUFFER_DEFINE(bench_mpmc, BENCH_BUFFER_SIZE, sizeof(struct bench_item));
+EASY_DATA_RINGBUFFER_DEFINE(bench_locked, BENCH_BUFFER_SIZE, sizeof(struct bench_item));
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct bench_consumer bench_consumers[BENCH_THREADS_MAX];
+static uint32_t bench_producer_items;
+static uint32_t bench_total_items;
+static uint32_t bench_received;
+static int bench_use_lock;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t bench_hist_bucket(uint64_t ns)
+{
+    if (ns < 8)
+    {
+        return (uint32_t)ns;
+    }
+
+    uint32_t exp = 63 - __builtin_clzll(ns);
+    return (exp - 2) * 8 + (uint32_t)((ns >> (exp - 3)) & 7);
+}
+
+static uint64_t bench_hist_value(uint32_t bucket)
+{
+    if (bucket < 8)
+    {
+        return bucket;
+    }
+
+    return (uint64_t)(8 + bucket % 8) << (bucket / 8 - 1);
+}
+
+static int bench_put(struct bench_item *item)
+{
+    int ret;
+
+    if (!bench_use_lock)
+    {
+        return easy_mpmc_ringbuffer_put(&bench_mpmc, item);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    ret = easy_data_ringbuffer_put(&bench_locked, item);
+    pthread_mutex_unlock(&bench_lock);
+    return ret;
+}
+
+static int bench_get(struct bench_item *item)
+{
+    int ret;
+
+    if (!bench_use_lock)
+    {
+        return easy_mpmc_ringbuffer_get(&bench_mpmc, item);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    ret = easy_data_ringbuffer_get(&bench_locked, item);
+    pthread_mutex_unlock(&bench_lock);
+    return ret;
+}
+
+static void *bench_producer(void *arg)
+{
+    struct bench_item item;
+
+    item.producer = (uint32_t)(uintptr_t)arg;
+    for (uint32_t seq = 0; seq < bench_producer_items;)
+    {
+        item.seq = seq;
+        item.stamp = bench_now_ns();
+        if (bench_put(&item) == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        seq++;
+    }
+
+    return NULL;
+}
+
+static void *bench_consumer(void *arg)
+{
+    struct bench_consumer *consumer = arg;
+    struct bench_item item;
+
+    while (EASY_ATOMIC_LOAD(&bench_received, EASY_ATOMIC_RELAXED) < bench_total_items)
+    {
+        if (bench_get(&item) == 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        consumer->hist[bench_hist_bucket(bench_now_ns() - item.stamp)]++;
+        consumer->seq_sum += item.seq;
+        consumer->received++;
+        EASY_ATOMIC_FETCH_ADD(&bench_received, 1, EASY_ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static void bench_run(const char *name, int use_lock, uint32_t threads)
+{
+    static uint64_t hist[BENCH_HIST_BUCKETS];
+    static const double percentiles[] = {0.5, 0.99, 0.999};
+    pthread_t producers[BENCH_THREADS_MAX];
+    uint64_t seq_sum = 0;
+    uint32_t received = 0;
+
+    EASY_MPMC_RINGBUFFER_INIT(bench_mpmc, BENCH_BUFFER_SIZE, sizeof(struct bench_item));
+    EASY_DATA_RINGBUFFER_INIT(bench_locked, BENCH_BUFFER_SIZE, sizeof(struct bench_item));
+    memset(bench_consumers, 0, sizeof(bench_consumers));
+    memset(hist, 0, sizeof(hist));
+    bench_use_lock = use_lock;
+    bench_producer_items = BENCH_TOTAL_ITEMS / threads;
+    bench_total_items = bench_producer_items * threads;
+    bench_received = 0;
+
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        pthread_create(&bench_consumers[i].thread, NULL, bench_consumer, &bench_consumers[i]);
+        pthread_create(&producers[i], NULL, bench_producer, (void *)(uintptr_t)i);
+    }
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        pthread_join(producers[i], NULL);
+        pthread_join(bench_consumers[i].thread, NULL);
+    }
+    double seconds = (bench_now_ns() - start) * 1e-9;
+
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        for (uint32_t b = 0; b < BENCH_HIST_BUCKETS; b++)
+        {
+            hist[b] += bench_consumers[i].hist[b];
+        }
+        seq_sum += bench_consumers[i].seq_sum;
+        received += bench_consumers[i].received;
+    }
+
+    printf("%-6s %2u x %-2u %10.0f ops/s", name, threads, threads, received / seconds);
+    for (uint32_t p = 0, b = 0, count = 0; p < EASY_ARRAY_SIZE(percentiles); p++)
+    {
+        while (b < BENCH_HIST_BUCKETS && count + hist[b] < percentiles[p] * received)
+        {
+            count += hist[b++];
+        }
+        printf("  p%-5g %8llu ns", percentiles[p] * 100, (unsigned long long)bench_hist_value(b));
+    }
+    printf("%s\n", seq_sum == (uint64_t)threads * bench_producer_items * (bench_producer_items - 1) / 2 ? "" : "  (data error)");
+}
+
+int main(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads_max = (uint32_t)EASY_MIN(EASY_MAX(cores, 2), BENCH_THREADS_MAX);
+
+    printf("%u items through a %u items ringbuffer, %ld cores, producers x consumers\n", BENCH_TOTAL_ITEMS, BENCH_BUFFER_SIZE, cores);
+    for (uint32_t threads = 1; threads <= threads_max; threads = (threads < threads_max && threads * 2 > threads_max) ? threads_max : threads * 2)
+    {
+        bench_run("mpmc", 0, threads);
+        bench_run("mutex", 1, threads);
+    }
+
+    return 0;
+}
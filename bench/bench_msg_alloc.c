@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+/*
+ * Message allocator benchmark, every round allocates BENCH_INFLIGHT messages
+ * like a burst of events queued to a task, then frees them in FIFO order.
+ * Build with 'make bench', the result is nanoseconds per alloc/free pair.
+ */
+#define BENCH_ROUNDS    200000
+#define BENCH_INFLIGHT  16
+#define BENCH_HEAP_SIZE 0x10000
+#define BENCH_ITEM_SIZE (sizeof(struct easy_msg) + 64)
+
+static uint32_t bench_heap_buffer[BENCH_HEAP_SIZE / sizeof(uint32_t)];
+static easy_heap_t bench_heap;
+
+EASY_POOL_DEFINE(bench_pool, BENCH_INFLIGHT, BENCH_ITEM_SIZE);
+EASY_ARENA_DEFINE(bench_arena, BENCH_INFLIGHT * BENCH_ITEM_SIZE);
+
+static void *bench_system_alloc(void *ctx, uint32_t size)
+{
+    (void)ctx;
+    return malloc(size);
+}
+
+static void bench_system_free(void *ctx, void *ptr, uint32_t size)
+{
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+static const struct easy_msg_allocator bench_allocator_heap = {easy_heap_hook_alloc, easy_heap_hook_free, &bench_heap};
+static const struct easy_msg_allocator bench_allocator_pool = {easy_pool_hook_alloc, easy_pool_hook_free, &bench_pool};
+static const struct easy_msg_allocator bench_allocator_arena = {easy_arena_hook_alloc, easy_arena_hook_free, &bench_arena};
+static const struct easy_msg_allocator bench_allocator_system = {bench_system_alloc, bench_system_free, NULL};
+
+static void bench_run(const char *name, const struct easy_msg_allocator *allocator, easy_arena_t *arena)
+{
+    struct easy_msg *msgs[BENCH_INFLIGHT];
+    uint32_t failed = 0;
+
+    clock_t start = clock();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int i = 0; i < BENCH_INFLIGHT; i++)
+        {
+            // mix the sizes, the pool item fits the largest one.
+            msgs[i] = easy_msg_alloc_len_from(allocator, i, 8 + (i & 7) * 8);
+            failed += (msgs[i] == NULL);
+        }
+        for (int i = 0; i < BENCH_INFLIGHT; i++)
+        {
+            easy_msg_free(msgs[i]);
+        }
+        if (arena != NULL)
+        {
+            easy_arena_reset(arena);
+        }
+    }
+    clock_t end = clock();
+
+    double ns = (double)(end - start) * 1e9 / CLOCKS_PER_SEC / ((double)BENCH_ROUNDS * BENCH_INFLIGHT);
+    printf("%-16s %8.1f ns/msg%s\n", name, ns, failed ? "  (allocation failed)" : "");
+}
+
+int main(void)
+{
+    easy_tools_init();
+    easy_heap_instance_init(&bench_heap, bench_heap_buffer, sizeof(bench_heap_buffer));
+    EASY_POOL_INIT(bench_pool, BENCH_INFLIGHT, BENCH_ITEM_SIZE);
+    EASY_ARENA_INIT(bench_arena);
+
+    printf("%d rounds of %d messages\n", BENCH_ROUNDS, BENCH_INFLIGHT);
+    bench_run("default", NULL, NULL);
+    bench_run("heap instance", &bench_allocator_heap, NULL);
+    bench_run("pool", &bench_allocator_pool, NULL);
+    bench_run("arena", &bench_allocator_arena, &bench_arena);
+    bench_run("system malloc", &bench_allocator_system, NULL);
+
+    return 0;
+}
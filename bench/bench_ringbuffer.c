@@ -0,0 +1,72 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+/*
+ * easy_ringbuffer index arithmetic benchmark, put and get transfers of a fixed
+ * size on a 4096 bytes ringbuffer with the power of 2 mode, and on the same
+ * ringbuffer forced to mirrored indices. The buffer is kept half full so the
+ * transfers wrap at every position.
+ */
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_TOTAL_BYTES (256u * 1024 * 1024)
+#define BENCH_CHUNK_MAX   1500
+
+static uint8_t bench_buffer[BENCH_BUFFER_SIZE];
+static uint8_t bench_data[BENCH_CHUNK_MAX];
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double bench_run(int use_mask, uint32_t chunk)
+{
+    easy_ringbuffer_t ringbuf;
+    volatile uint32_t check = 0;
+    uint32_t count = BENCH_TOTAL_BYTES / chunk;
+
+    easy_ringbuffer_init(&ringbuf, BENCH_BUFFER_SIZE, bench_buffer);
+    if (!use_mask)
+    {
+        ringbuf.mask = 0;
+    }
+    easy_ringbuffer_put(&ringbuf, bench_data, BENCH_BUFFER_SIZE / 2 - chunk / 2);
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        easy_ringbuffer_put(&ringbuf, bench_data, chunk);
+        check += easy_ringbuffer_size(&ringbuf);
+        easy_ringbuffer_get(&ringbuf, bench_data, chunk);
+    }
+    double seconds = bench_now() - start;
+
+    return (double)count / seconds / 1e6;
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {1, 16, 1500};
+
+    printf("%u bytes ringbuffer, million put+get per second\n", BENCH_BUFFER_SIZE);
+    printf("%-8s %10s %10s %8s\n", "chunk", "mirrored", "pow2", "speedup");
+    for (uint32_t i = 0; i < EASY_ARRAY_SIZE(chunks); i++)
+    {
+        double mirrored = bench_run(0, chunks[i]);
+        double pow2 = bench_run(1, chunks[i]);
+
+        printf("%-8u %10.2f %10.2f %7.2fx\n", chunks[i], mirrored, pow2, pow2 / mirrored);
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+#include <unistd.h>
+
+/*
+ * Filling easy_ringbuffer from a local pipe, read() into a stack buffer and
+ * easy_ringbuffer_put() against one easy_ringbuffer_read_from_fd(). The
+ * writer side of the pipe and the consumer (a plain release) cost the same in
+ * both runs.
+ */
+#define BENCH_BUFFER_SIZE 0x10000
+#define BENCH_TOTAL_BYTES (256u * 1024 * 1024)
+#define BENCH_CHUNK_MAX   16384
+
+static uint8_t bench_buffer[BENCH_BUFFER_SIZE];
+static uint8_t bench_source[BENCH_CHUNK_MAX];
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double bench_run(int use_readv, uint32_t chunk)
+{
+    easy_ringbuffer_t ringbuf;
+    uint8_t stack[BENCH_CHUNK_MAX];
+    uint32_t count = BENCH_TOTAL_BYTES / chunk;
+    int fds[2];
+
+    if (pipe(fds) != 0)
+    {
+        return 0;
+    }
+
+    easy_ringbuffer_init(&ringbuf, BENCH_BUFFER_SIZE, bench_buffer);
+
+    double start = bench_now();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t len = 0;
+
+        if (write(fds[1], bench_source, chunk) != (ssize_t)chunk)
+        {
+            break;
+        }
+
+        while (len < chunk)
+        {
+            ssize_t ret;
+
+            if (use_readv)
+            {
+                ret = easy_ringbuffer_read_from_fd(&ringbuf, fds[0], chunk - len);
+            }
+            else
+            {
+                ret = read(fds[0], stack, chunk - len);
+                if (ret > 0)
+                {
+                    easy_ringbuffer_put(&ringbuf, stack, (uint32_t)ret);
+                }
+            }
+
+            if (ret <= 0)
+            {
+                break;
+            }
+            len += (uint32_t)ret;
+        }
+
+        // keep it half full, so the reads wrap
+        if (easy_ringbuffer_size(&ringbuf) > BENCH_BUFFER_SIZE / 2)
+        {
+            easy_ringbuffer_read_release(&ringbuf, easy_ringbuffer_size(&ringbuf) - BENCH_BUFFER_SIZE / 2);
+        }
+    }
+    double seconds = bench_now() - start;
+
+    close(fds[0]);
+    close(fds[1]);
+
+    return (double)count * chunk / seconds / 1e6;
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {64, 1500, 16384};
+
+    printf("pipe to %u bytes ringbuffer, MB/s\n", BENCH_BUFFER_SIZE);
+    printf("%-8s %10s %10s %8s\n", "chunk", "stack", "readv", "speedup");
+    for (uint32_t i = 0; i < EASY_ARRAY_SIZE(chunks); i++)
+    {
+        double stack = bench_run(0, chunks[i]);
+        double readv = bench_run(1, chunks[i]);
+
+        printf("%-8u %10.1f %10.1f %7.2fx\n", chunks[i], stack, readv, readv / stack);
+    }
+
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("bench_ringbuffer_fd needs EASY_CONFIG_RINGBUFFER_FD_IO\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+#include <pthread.h>
+
+/*
+ * Wake-up latency of a consumer of easy_ringbuffer, from the put to the
+ * consumer seeing the data, when it sleeps in easy_ringbuffer_wait_readable
+ * and when it polls easy_ringbuffer_size every millisecond.
+ */
+#define BENCH_BUFFER_SIZE 1024
+#define BENCH_ROUNDS      2000
+
+static uint8_t bench_buffer[BENCH_BUFFER_SIZE];
+static easy_ringbuffer_t bench_ringbuf;
+static int bench_use_wait;
+static double bench_latency[BENCH_ROUNDS];
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *bench_consumer(void *arg)
+{
+    struct timespec tick = {0, 1000 * 1000};
+    double sent;
+
+    (void)arg;
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+    {
+        if (bench_use_wait)
+        {
+            easy_ringbuffer_wait_readable(&bench_ringbuf, sizeof(sent), EASY_RINGBUFFER_WAIT_FOREVER);
+        }
+        else
+        {
+            while (easy_ringbuffer_size(&bench_ringbuf) < sizeof(sent))
+            {
+                nanosleep(&tick, NULL);
+            }
+        }
+
+        double now = bench_now();
+        easy_ringbuffer_get(&bench_ringbuf, (uint8_t *)&sent, sizeof(sent));
+        bench_latency[i] = now - sent;
+    }
+
+    return NULL;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void bench_run(const char *name, int use_wait)
+{
+    struct timespec gap = {0, 200 * 1000};
+    pthread_t consumer;
+    double sum = 0;
+
+    easy_ringbuffer_init(&bench_ringbuf, BENCH_BUFFER_SIZE, bench_buffer);
+    bench_use_wait = use_wait;
+    pthread_create(&consumer, NULL, bench_consumer, NULL);
+
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+    {
+        // let the consumer go idle first
+        nanosleep(&gap, NULL);
+        while (easy_ringbuffer_size(&bench_ringbuf) != 0)
+        {
+            nanosleep(&gap, NULL);
+        }
+
+        double now = bench_now();
+        easy_ringbuffer_put(&bench_ringbuf, (uint8_t *)&now, sizeof(now));
+    }
+    pthread_join(consumer, NULL);
+
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+    {
+        sum += bench_latency[i];
+    }
+    qsort(bench_latency, BENCH_ROUNDS, sizeof(bench_latency[0]), bench_compare);
+
+    printf("%-10s avg %8.1f us  p50 %8.1f us  p99 %8.1f us\n", name, sum / BENCH_ROUNDS * 1e6, bench_latency[BENCH_ROUNDS / 2] * 1e6,
+           bench_latency[BENCH_ROUNDS * 99 / 100] * 1e6);
+}
+
+int main(void)
+{
+    printf("consumer wake-up latency, %d rounds\n", BENCH_ROUNDS);
+    bench_run("wait", 1);
+    bench_run("poll 1ms", 0);
+
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("bench_ringbuffer_wait needs EASY_CONFIG_RINGBUFFER_WAIT\n");
+    return 0;
+}
+#endif
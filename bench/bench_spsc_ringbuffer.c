@@ -0,0 +1,157 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "easy_tools.h"
+
+/*
+ * SPSC ringbuffer benchmark, a producer thread streams BENCH_TOTAL_BYTES
+ * through the ringbuffer in chunks and a consumer thread checks the byte
+ * sequence. The lock-free easy_spsc_ringbuffer is compared with
+ * easy_ringbuffer protected by a mutex.
+ */
+#define BENCH_BUFFER_SIZE 0x10000
+#define BENCH_TOTAL_BYTES (256u * 1024 * 1024)
+#define BENCH_CHUNK_MAX   4096
+
+static uint8_t bench_buffer[BENCH_BUFFER_SIZE];
+static easy_spsc_ringbuffer_t bench_spsc;
+static easy_ringbuffer_t bench_locked;
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t bench_chunk;
+static int bench_use_lock;
+static int bench_error;
+
+static uint32_t bench_put(const uint8_t *data, uint32_t len)
+{
+    uint32_t ret;
+
+    if (!bench_use_lock)
+    {
+        return easy_spsc_ringbuffer_put(&bench_spsc, data, len);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    ret = easy_ringbuffer_put(&bench_locked, (uint8_t *)data, len);
+    pthread_mutex_unlock(&bench_lock);
+    return ret;
+}
+
+static uint32_t bench_get(uint8_t *data, uint32_t len)
+{
+    uint32_t ret;
+
+    if (!bench_use_lock)
+    {
+        return easy_spsc_ringbuffer_get(&bench_spsc, data, len);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    ret = easy_ringbuffer_get(&bench_locked, data, len);
+    pthread_mutex_unlock(&bench_lock);
+    return ret;
+}
+
+static void *bench_producer(void *arg)
+{
+    uint8_t data[BENCH_CHUNK_MAX];
+    uint8_t seq = 0;
+    uint32_t sent = 0;
+
+    (void)arg;
+    while (sent < BENCH_TOTAL_BYTES)
+    {
+        for (uint32_t i = 0; i < bench_chunk; i++)
+        {
+            data[i] = (uint8_t)(seq + i);
+        }
+
+        uint32_t len = bench_put(data, EASY_MIN(bench_chunk, BENCH_TOTAL_BYTES - sent));
+        if (len == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        sent += len;
+        seq += (uint8_t)len;
+    }
+
+    return NULL;
+}
+
+static void *bench_consumer(void *arg)
+{
+    uint8_t data[BENCH_CHUNK_MAX];
+    uint8_t seq = 0;
+    uint32_t received = 0;
+
+    (void)arg;
+    while (received < BENCH_TOTAL_BYTES)
+    {
+        uint32_t len = bench_get(data, bench_chunk);
+        if (len == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < len; i++)
+        {
+            if (data[i] != seq++)
+            {
+                bench_error = 1;
+            }
+        }
+        received += len;
+    }
+
+    return NULL;
+}
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_run(const char *name, int use_lock, uint32_t chunk)
+{
+    pthread_t producer, consumer;
+
+    easy_spsc_ringbuffer_init(&bench_spsc, BENCH_BUFFER_SIZE, bench_buffer);
+    easy_ringbuffer_init(&bench_locked, BENCH_BUFFER_SIZE, bench_buffer);
+    bench_use_lock = use_lock;
+    bench_chunk = chunk;
+    bench_error = 0;
+
+    double start = bench_now();
+    pthread_create(&consumer, NULL, bench_consumer, NULL);
+    pthread_create(&producer, NULL, bench_producer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    double seconds = bench_now() - start;
+
+    printf("%-8s chunk %5u  %8.1f MB/s%s\n", name, chunk, BENCH_TOTAL_BYTES / seconds / 1e6, bench_error ? "  (data error)" : "");
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {16, 256, 4096};
+
+    printf("%u MB through a %u bytes ringbuffer\n", BENCH_TOTAL_BYTES >> 20, BENCH_BUFFER_SIZE);
+    for (uint32_t i = 0; i < EASY_ARRAY_SIZE(chunks); i++)
+    {
+        bench_run("spsc", 0, chunks[i]);
+        bench_run("mutex", 1, chunks[i]);
+    }
+
+    return 0;
+}
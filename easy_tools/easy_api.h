@@ -3,6 +3,7 @@
 
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "easy_tools_config.h"
@@ -28,7 +29,7 @@ void easy_hw_interrupt_enable(int level);
 struct easy_heap_ptr
 {
     void *buf;
-    uint32_t len;
+    size_t len;
 };
 
 void easy_tools_api_log(const char *format, ...);
@@ -0,0 +1,59 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "easy_arena.h"
+#include "easy_tools_common.h"
+
+#define ARENA_ALIGN_MASK ((uint32_t)EASY_ARENA_ALIGN_SIZE - 1)
+
+void easy_arena_init(easy_arena_t *arena, void *buffer, uint32_t total_size)
+{
+    uintptr_t address = ((uintptr_t)buffer + ARENA_ALIGN_MASK) & ~(uintptr_t)ARENA_ALIGN_MASK;
+    uint32_t offset = (uint32_t)(address - (uintptr_t)buffer);
+
+    /* Align the start, so every allocation is aligned by its offset. */
+    if (buffer == NULL || total_size < offset)
+    {
+        address = 0;
+        total_size = 0;
+    }
+    else
+    {
+        total_size -= offset;
+    }
+
+    arena->buffer = (uint8_t *)address;
+    arena->total_size = total_size & ~ARENA_ALIGN_MASK;
+    arena->used_size = 0;
+    arena->peak_size = 0;
+}
+
+void *easy_arena_alloc(easy_arena_t *arena, uint32_t size)
+{
+    uint32_t offset = arena->used_size;
+
+    if (size > arena->total_size - offset)
+    {
+        return NULL;
+    }
+
+    arena->used_size = EASY_MIN(offset + ((size + ARENA_ALIGN_MASK) & ~ARENA_ALIGN_MASK), arena->total_size);
+    if (arena->used_size > arena->peak_size)
+    {
+        arena->peak_size = arena->used_size;
+    }
+
+    return arena->buffer + offset;
+}
+
+void *easy_arena_hook_alloc(void *ctx, uint32_t size)
+{
+    return easy_arena_alloc((easy_arena_t *)ctx, size);
+}
+
+void easy_arena_hook_free(void *ctx, void *ptr, uint32_t size)
+{
+    EASY_UNUSED(ctx);
+    EASY_UNUSED(ptr);
+    EASY_UNUSED(size);
+}
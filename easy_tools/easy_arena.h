@@ -0,0 +1,120 @@
+#ifndef _EASY_ARENA_H_
+#define _EASY_ARENA_H_
+
+/** Includes -----------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Define -------------------------------------------------------------------*/
+
+/* Every allocation of the arena is aligned to this size. */
+#define EASY_ARENA_ALIGN_SIZE sizeof(void *)
+
+/**
+ * @brief   Bump allocator on a fixed buffer.
+ * @details Allocations only move used_size forward, memory is given back all
+ *   at once by easy_arena_reset, or back to a savepoint by
+ *   easy_arena_rollback. Not thread safe.
+ */
+typedef struct easy_arena
+{
+    uint8_t *buffer;
+    uint32_t total_size; /* Size of the buffer */
+    uint32_t used_size;  /* Bytes allocated */
+    uint32_t peak_size;  /* Max used_size since init */
+} easy_arena_t;
+
+/* Savepoint of an arena, the used size at the time it is taken. */
+typedef uint32_t easy_arena_mark_t;
+
+#define EASY_ARENA_DEFINE(_name, _size)                                                                                                                        \
+    static void *_name##_data_storage[((_size) + sizeof(void *) - 1) / sizeof(void *)];                                                                        \
+    static easy_arena_t _name = {.buffer = (uint8_t *)_name##_data_storage, .total_size = sizeof(_name##_data_storage), .used_size = 0, .peak_size = 0}
+
+#define EASY_ARENA_INIT(_name) easy_arena_init(&_name, _name##_data_storage, sizeof(_name##_data_storage))
+
+/** Exported functions -------------------------------------------------------*/
+
+/**
+ * @brief  Initialize the arena.
+ * @param  [in] arena: The arena to be used.
+ * @param  [in] buffer: The buffer to allocate from.
+ * @param  [in] total_size: The size of the buffer in bytes.
+ */
+void easy_arena_init(easy_arena_t *arena, void *buffer, uint32_t total_size);
+
+/**
+ * @brief  Allocate memory from the arena.
+ * @param  [in] arena: The arena to be used.
+ * @param  [in] size: The wanted size in bytes.
+ * @return The allocated memory, NULL if the arena is full.
+ */
+void *easy_arena_alloc(easy_arena_t *arena, uint32_t size);
+
+/**
+ * @brief  Take a savepoint, savepoints may be nested.
+ * @param  [in] arena: The arena to be used.
+ * @return The savepoint.
+ */
+static inline easy_arena_mark_t easy_arena_save(easy_arena_t *arena)
+{
+    return arena->used_size;
+}
+
+/**
+ * @brief  Free everything allocated after the savepoint was taken, the
+ *         savepoints taken after it are invalid then.
+ * @param  [in] arena: The arena to be used.
+ * @param  [in] mark: The savepoint from easy_arena_save.
+ */
+static inline void easy_arena_rollback(easy_arena_t *arena, easy_arena_mark_t mark)
+{
+    if (mark < arena->used_size)
+    {
+        arena->used_size = mark;
+    }
+}
+
+/**
+ * @brief  Free everything allocated from the arena.
+ * @param  [in] arena: The arena to be used.
+ */
+static inline void easy_arena_reset(easy_arena_t *arena)
+{
+    arena->used_size = 0;
+}
+
+/**
+ * @brief  Returns the bytes allocated from the arena.
+ */
+static inline uint32_t easy_arena_used_size(easy_arena_t *arena)
+{
+    return arena->used_size;
+}
+
+/**
+ * @brief  Returns the bytes still free in the arena.
+ */
+static inline uint32_t easy_arena_reserve_size(easy_arena_t *arena)
+{
+    return arena->total_size - arena->used_size;
+}
+
+/**
+ * @brief  Allocator hook adapters, ctx is the arena. The free is a no-op,
+ *         the memory comes back on reset or rollback.
+ */
+void *easy_arena_hook_alloc(void *ctx, uint32_t size);
+void easy_arena_hook_free(void *ctx, void *ptr, uint32_t size);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*!< _EASY_ARENA_H_ */
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_broadcast_ring.h"
+
+#define BROADCAST_RING_SLOT(_ring, _index) ((_ring)->buffer + (size_t)((_index) & ((_ring)->total_size - 1)) * (_ring)->item_size)
+
+/* Look at all the cursors and keep the slowest one. */
+static uint32_t broadcast_ring_update_gate(easy_broadcast_ring_t *ring)
+{
+    uint32_t write_index = ring->write_index;
+    uint32_t used = 0;
+    easy_snode_t *node;
+
+    EASY_SLIST_FOR_EACH_NODE(&ring->consumers, node)
+    {
+        easy_broadcast_consumer_t *consumer = EASY_SLIST_ENTRY(node, easy_broadcast_consumer_t, node);
+        uint32_t consumer_used = write_index - EASY_ATOMIC_LOAD(&consumer->cursor, EASY_ATOMIC_ACQUIRE);
+
+        used = EASY_MAX(used, consumer_used);
+    }
+    ring->gate_cache = write_index - used;
+
+    return used;
+}
+
+int easy_broadcast_ring_init(easy_broadcast_ring_t *ring, uint32_t total_size, uint32_t item_size, void *buffer)
+{
+    if (total_size == 0 || (total_size & (total_size - 1)) != 0)
+    {
+        return -1;
+    }
+
+    ring->total_size = total_size;
+    ring->item_size = item_size;
+    ring->buffer = buffer;
+    easy_slist_init(&ring->consumers);
+    ring->write_index = 0;
+    ring->gate_cache = 0;
+
+    return 0;
+}
+
+void easy_broadcast_ring_add_consumer(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, easy_broadcast_consumer_t *depends)
+{
+    consumer->depends = depends;
+    consumer->cursor = depends ? EASY_ATOMIC_LOAD(&depends->cursor, EASY_ATOMIC_ACQUIRE) : ring->write_index;
+    easy_slist_append(&ring->consumers, &consumer->node);
+}
+
+void easy_broadcast_ring_remove_consumer(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer)
+{
+    easy_slist_find_and_remove(&ring->consumers, &consumer->node);
+}
+
+uint32_t easy_broadcast_ring_size(easy_broadcast_ring_t *ring)
+{
+    return broadcast_ring_update_gate(ring);
+}
+
+void *easy_broadcast_ring_enqueue_get(easy_broadcast_ring_t *ring)
+{
+    /* only look at the consumer lines when the cached cursor says it is full */
+    if (ring->write_index - ring->gate_cache >= ring->total_size && broadcast_ring_update_gate(ring) >= ring->total_size)
+    {
+        return NULL;
+    }
+
+    return BROADCAST_RING_SLOT(ring, ring->write_index);
+}
+
+int easy_broadcast_ring_put(easy_broadcast_ring_t *ring, const void *buffer)
+{
+    void *mem = easy_broadcast_ring_enqueue_get(ring);
+
+    if (mem == NULL)
+    {
+        return 0;
+    }
+
+    memcpy(mem, buffer, ring->item_size);
+    easy_broadcast_ring_enqueue(ring);
+
+    return 1;
+}
+
+void *easy_broadcast_ring_peek(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, uint32_t offset)
+{
+    if (offset >= easy_broadcast_ring_available(ring, consumer))
+    {
+        return NULL;
+    }
+
+    return BROADCAST_RING_SLOT(ring, consumer->cursor + offset);
+}
+
+int easy_broadcast_ring_get(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, void *buffer)
+{
+    void *mem = easy_broadcast_ring_peek(ring, consumer, 0);
+
+    if (mem == NULL)
+    {
+        return 0;
+    }
+
+    memcpy(buffer, mem, ring->item_size);
+    easy_broadcast_ring_release(ring, consumer, 1);
+
+    return 1;
+}
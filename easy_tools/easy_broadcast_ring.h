@@ -0,0 +1,173 @@
+#ifndef _EASY_BROADCAST_RING_H_
+#define _EASY_BROADCAST_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "easy_slist.h"
+#include "easy_tools_common.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   A reader of an easy_broadcast_ring, with its own cursor.
+ * @details A consumer may depend on another one, it then only sees the items
+ *   the other one has released, so the items flow through a chain of stages
+ *   (e.g. processor then forwarder) without copies. Every consumer runs on
+ *   one thread, its cursor is on its own cache line.
+ */
+typedef struct easy_broadcast_consumer
+{
+    uint32_t cursor __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Read. Next item to read */
+    struct easy_broadcast_consumer *depends;                         /* Items are gated by this consumer, NULL for the producer */
+    easy_snode_t node;
+} easy_broadcast_consumer_t;
+
+/**
+ * @brief   One producer, many consumers ring of fixed size items.
+ * @details Every item is written once and read in place by all the consumers
+ *   (disruptor style). The producer only reuses a slot once the slowest
+ *   consumer has released it, it keeps the slowest cursor it saw and only
+ *   looks at the consumer cursors again when that one says the ring is full.
+ *   The indices run freely over uint32_t, so total_size must be a power of 2.
+ */
+typedef struct easy_broadcast_ring
+{
+    uint32_t total_size; /* Number of buffers, a power of 2 */
+    uint32_t item_size;  /* Stride between elements */
+    uint8_t *buffer;
+    easy_slist_t consumers; /* Consumers gating the producer */
+
+    uint32_t write_index __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Write. Items published */
+    uint32_t gate_cache;                                                 /* Write. Slowest cursor seen */
+} easy_broadcast_ring_t;
+
+#ifndef EASY_MROUND
+#define EASY_MROUND(x) (((uint32_t)(x) + 3) & (~((uint32_t)3)))
+#endif
+
+#define EASY_BROADCAST_RING_DEFINE(_name, _num, _data_size)                                                                                                    \
+    static uint8_t _name##_data_storage[_num][EASY_MROUND(_data_size)];                                                                                        \
+    static easy_broadcast_ring_t _name = {.total_size = _num, .item_size = EASY_MROUND(_data_size), .buffer = (void *)_name##_data_storage}
+
+#define EASY_BROADCAST_RING_INIT(_name, _num, _data_size) easy_broadcast_ring_init(&_name, _num, EASY_MROUND(_data_size), (void *)_name##_data_storage)
+
+/**
+ * @brief  Initialize the ring, without consumers.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] total_size: The number of items, a power of 2.
+ * @param  [in] item_size: The stride between items.
+ * @param  [in] buffer: The buffer to be used, total_size * item_size bytes.
+ * @return 0 on success, -1 if total_size is not a power of 2.
+ */
+int easy_broadcast_ring_init(easy_broadcast_ring_t *ring, uint32_t total_size, uint32_t item_size, void *buffer);
+
+/**
+ * @brief  Add a consumer, it sees the items put from now on (or released by
+ *         depends from now on). The producer must not run at that time.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] consumer: The consumer to be added.
+ * @param  [in] depends: The consumer that must release an item before this one
+ *         sees it, NULL to read the items as soon as they are put.
+ */
+void easy_broadcast_ring_add_consumer(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, easy_broadcast_consumer_t *depends);
+
+/**
+ * @brief  Remove a consumer, no consumer may depend on it. The producer must
+ *         not run at that time.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] consumer: The consumer to be removed.
+ */
+void easy_broadcast_ring_remove_consumer(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer);
+
+/**
+ * @brief  Returns the item size of the ring in bytes.
+ */
+static inline uint32_t easy_broadcast_ring_item_size(easy_broadcast_ring_t *ring)
+{
+    return ring->item_size;
+}
+
+/**
+ * @brief  Returns the number of items the slowest consumer has not released,
+ *         for the producer thread.
+ */
+uint32_t easy_broadcast_ring_size(easy_broadcast_ring_t *ring);
+
+/**
+ * @brief  Returns the number of items a consumer can read, for its thread.
+ */
+static inline uint32_t easy_broadcast_ring_available(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer)
+{
+    /* the items a stage released are published, a stage only waits on its upstream */
+    uint32_t limit = consumer->depends ? EASY_ATOMIC_LOAD(&consumer->depends->cursor, EASY_ATOMIC_ACQUIRE)
+                                       : EASY_ATOMIC_LOAD(&ring->write_index, EASY_ATOMIC_ACQUIRE);
+
+    return limit - consumer->cursor;
+}
+
+/**
+ * @brief  Claim the next slot to be filled in place, for the producer thread.
+ * @param  [in] ring: The ring to be used.
+ * @return The slot, NULL if the slowest consumer has not released it yet.
+ */
+void *easy_broadcast_ring_enqueue_get(easy_broadcast_ring_t *ring);
+
+/**
+ * @brief  Publish the slot claimed by easy_broadcast_ring_enqueue_get to all
+ *         the consumers.
+ * @param  [in] ring: The ring to be used.
+ */
+static inline void easy_broadcast_ring_enqueue(easy_broadcast_ring_t *ring)
+{
+    EASY_ATOMIC_STORE(&ring->write_index, ring->write_index + 1, EASY_ATOMIC_RELEASE);
+}
+
+/**
+ * @brief  Copy an item in, enqueue_get + copy + enqueue.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] buffer: The item, item_size bytes.
+ * @return The number of items put into the ring, 0 if it is full.
+ */
+int easy_broadcast_ring_put(easy_broadcast_ring_t *ring, const void *buffer);
+
+/**
+ * @brief  Read an item in place, for the consumer thread.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] consumer: The consumer reading.
+ * @param  [in] offset: 0 for the next item, up to easy_broadcast_ring_available() - 1.
+ * @return The item, NULL if it is not available. It stays valid until the
+ *         consumer releases it.
+ */
+void *easy_broadcast_ring_peek(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, uint32_t offset);
+
+/**
+ * @brief  Release the next n items of a consumer, for the consumer thread.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] consumer: The consumer reading.
+ * @param  [in] n: The number of items read, no more than available.
+ */
+static inline void easy_broadcast_ring_release(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, uint32_t n)
+{
+    EASY_UNUSED(ring);
+    EASY_ATOMIC_STORE(&consumer->cursor, consumer->cursor + n, EASY_ATOMIC_RELEASE);
+}
+
+/**
+ * @brief  Copy the next item out and release it, peek + copy + release.
+ * @param  [in] ring: The ring to be used.
+ * @param  [in] consumer: The consumer reading.
+ * @param  [in] buffer: The buffer to get the item.
+ * @return The number of items get from the ring, 0 if none is available.
+ */
+int easy_broadcast_ring_get(easy_broadcast_ring_t *ring, easy_broadcast_consumer_t *consumer, void *buffer);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EASY_BROADCAST_RING_H_ */
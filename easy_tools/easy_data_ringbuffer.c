@@ -1,6 +1,7 @@
 #include <string.h>
 
 #include "easy_data_ringbuffer.h"
+#include "easy_tools_common.h"
 
 #ifndef MIN
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
@@ -8,10 +9,40 @@
 
 #define DATA_RINGBUFFER_INDEX_TO_PTR(_index, _total_size) ((_index >= _total_size) ? (_index - _total_size) : (_index))
 
+static inline easy_data_ringbuffer_index_t data_ringbuffer_index_next(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t index)
+{
+    index++;
+    if (index >= (ringbuf->total_size << 1))
+    {
+        index -= (ringbuf->total_size << 1);
+    }
+
+    return index;
+}
+
+static inline easy_data_ringbuffer_index_t data_ringbuffer_index_add(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t index,
+                                                                     easy_data_ringbuffer_index_t n)
+{
+    /* index + n may not fit the index type, compare with the distance to the end */
+    easy_data_ringbuffer_index_t rest = (ringbuf->total_size << 1) - index;
+
+    return n >= rest ? n - rest : index + n;
+}
+
+/* Split n items from ptr into the part before the end of the buffer and the part at its start. */
+static inline void data_ringbuffer_spans(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t ptr, easy_data_ringbuffer_index_t n, void *mem[2],
+                                         easy_data_ringbuffer_index_t count[2])
+{
+    count[0] = EASY_MIN(n, ringbuf->total_size - ptr);
+    count[1] = n - count[0];
+    mem[0] = ringbuf->buffer + (size_t)ptr * ringbuf->item_size;
+    mem[1] = ringbuf->buffer;
+}
+
 int easy_data_ringbuffer_put(easy_data_ringbuffer_t *ringbuf, void *buffer)
 {
-    uint16_t write_index;
-    uint16_t wptr;
+    easy_data_ringbuffer_index_t write_index;
+    easy_data_ringbuffer_index_t wptr;
 
     if (easy_data_ringbuffer_reserve_size(ringbuf) == 0)
     {
@@ -19,7 +50,7 @@ int easy_data_ringbuffer_put(easy_data_ringbuffer_t *ringbuf, void *buffer)
     }
 
     wptr = DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->write_index, ringbuf->total_size);
-    memcpy(ringbuf->buffer + wptr * ringbuf->item_size, buffer, ringbuf->item_size);
+    memcpy(ringbuf->buffer + (size_t)wptr * ringbuf->item_size, buffer, ringbuf->item_size);
 
     write_index = ringbuf->write_index + 1;
     if (write_index >= (ringbuf->total_size << 1))
@@ -33,8 +64,8 @@ int easy_data_ringbuffer_put(easy_data_ringbuffer_t *ringbuf, void *buffer)
 
 int easy_data_ringbuffer_get(easy_data_ringbuffer_t *ringbuf, void *buffer)
 {
-    uint16_t read_index;
-    uint16_t rptr;
+    easy_data_ringbuffer_index_t read_index;
+    easy_data_ringbuffer_index_t rptr;
     if (easy_data_ringbuffer_size(ringbuf) == 0)
     {
         return 0;
@@ -43,7 +74,7 @@ int easy_data_ringbuffer_get(easy_data_ringbuffer_t *ringbuf, void *buffer)
     if (buffer != NULL)
     {
         rptr = DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->read_index, ringbuf->total_size);
-        memcpy(buffer, ringbuf->buffer + rptr * ringbuf->item_size, ringbuf->item_size);
+        memcpy(buffer, ringbuf->buffer + (size_t)rptr * ringbuf->item_size, ringbuf->item_size);
     }
 
     read_index = ringbuf->read_index + 1;
@@ -56,9 +87,9 @@ int easy_data_ringbuffer_get(easy_data_ringbuffer_t *ringbuf, void *buffer)
     return 1;
 }
 
-int easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem)
+easy_data_ringbuffer_index_t easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem)
 {
-    uint16_t wptr = DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->write_index, ringbuf->total_size);
+    easy_data_ringbuffer_index_t wptr = DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->write_index, ringbuf->total_size);
 
     if (easy_data_ringbuffer_reserve_size(ringbuf) == 0)
     {
@@ -71,9 +102,9 @@ int easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem
      * buffer (last). Recall that last has not been updated,
      * so idx != last
      */
-    *mem = ringbuf->buffer + wptr * ringbuf->item_size; /* preceding buffer */
+    *mem = ringbuf->buffer + (size_t)wptr * ringbuf->item_size; /* preceding buffer */
 
-    uint16_t write_index = ringbuf->write_index + 1;
+    easy_data_ringbuffer_index_t write_index = ringbuf->write_index + 1;
     if (write_index >= (ringbuf->total_size << 1))
     {
         write_index -= (ringbuf->total_size << 1);
@@ -82,25 +113,143 @@ int easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem
     return write_index;
 }
 
-void easy_data_ringbuffer_enqueue(easy_data_ringbuffer_t *ringbuf, uint16_t write_index)
+void easy_data_ringbuffer_enqueue(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t write_index)
 {
     ringbuf->write_index = write_index; /* Commit: Update write index */
 }
 
+easy_data_ringbuffer_index_t easy_data_ringbuffer_put_n(easy_data_ringbuffer_t *ringbuf, const void *buffer, easy_data_ringbuffer_index_t n)
+{
+    void *mem[2];
+    easy_data_ringbuffer_index_t count[2];
+
+    n = easy_data_ringbuffer_enqueue_get_n(ringbuf, n, mem, count);
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    memcpy(mem[0], buffer, (size_t)count[0] * ringbuf->item_size);
+    memcpy(mem[1], (const uint8_t *)buffer + (size_t)count[0] * ringbuf->item_size, (size_t)count[1] * ringbuf->item_size);
+
+    easy_data_ringbuffer_enqueue_n(ringbuf, n);
+
+    return n;
+}
+
+easy_data_ringbuffer_index_t easy_data_ringbuffer_get_n(easy_data_ringbuffer_t *ringbuf, void *buffer, easy_data_ringbuffer_index_t n)
+{
+    void *mem[2];
+    easy_data_ringbuffer_index_t count[2];
+
+    n = EASY_MIN(n, easy_data_ringbuffer_size(ringbuf));
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    if (buffer != NULL)
+    {
+        data_ringbuffer_spans(ringbuf, DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->read_index, ringbuf->total_size), n, mem, count);
+        memcpy(buffer, mem[0], (size_t)count[0] * ringbuf->item_size);
+        memcpy((uint8_t *)buffer + (size_t)count[0] * ringbuf->item_size, mem[1], (size_t)count[1] * ringbuf->item_size);
+    }
+
+    ringbuf->read_index = data_ringbuffer_index_add(ringbuf, ringbuf->read_index, n);
+
+    return n;
+}
+
+easy_data_ringbuffer_index_t easy_data_ringbuffer_enqueue_get_n(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t n, void *mem[2],
+                                                                easy_data_ringbuffer_index_t count[2])
+{
+    n = EASY_MIN(n, easy_data_ringbuffer_reserve_size(ringbuf));
+    data_ringbuffer_spans(ringbuf, DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->write_index, ringbuf->total_size), n, mem, count);
+
+    return n;
+}
+
+void easy_data_ringbuffer_enqueue_n(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t n)
+{
+    ringbuf->write_index = data_ringbuffer_index_add(ringbuf, ringbuf->write_index, n); /* Commit: Update write index */
+}
+
 void *easy_data_ringbuffer_dequeue_peek(easy_data_ringbuffer_t *ringbuf)
 {
-    uint16_t read_index;
-    uint16_t rptr;
+    easy_data_ringbuffer_index_t read_index;
+    easy_data_ringbuffer_index_t rptr;
     if (easy_data_ringbuffer_size(ringbuf) == 0)
     {
         return NULL;
     }
 
     rptr = DATA_RINGBUFFER_INDEX_TO_PTR(ringbuf->read_index, ringbuf->total_size);
-    return ringbuf->buffer + rptr * ringbuf->item_size;
+    return ringbuf->buffer + (size_t)rptr * ringbuf->item_size;
 }
 
 void easy_data_ringbuffer_dequeue(easy_data_ringbuffer_t *ringbuf)
 {
     easy_data_ringbuffer_get(ringbuf, NULL);
 }
+
+int easy_data_ringbuffer_put_overwrite(easy_data_ringbuffer_t *ringbuf, void *buffer)
+{
+    easy_data_ringbuffer_index_t read_index;
+    easy_data_ringbuffer_index_t write_index = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_RELAXED);
+    easy_data_ringbuffer_index_t wptr;
+
+    if (ringbuf->total_size == 0)
+    {
+        return 0;
+    }
+
+    /* full, drop the oldest item, a reader copying it sees its CAS fail */
+    do
+    {
+        read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+        easy_data_ringbuffer_index_t size = write_index >= read_index ? write_index - read_index : (ringbuf->total_size << 1) - (read_index - write_index);
+        if (size < ringbuf->total_size)
+        {
+            break;
+        }
+
+        if (EASY_ATOMIC_CAS(&ringbuf->read_index, &read_index, data_ringbuffer_index_next(ringbuf, read_index), EASY_ATOMIC_ACQ_REL))
+        {
+            EASY_ATOMIC_FETCH_ADD(&ringbuf->dropped, 1, EASY_ATOMIC_RELAXED);
+            break;
+        }
+    } while (1);
+
+    wptr = DATA_RINGBUFFER_INDEX_TO_PTR(write_index, ringbuf->total_size);
+    memcpy(ringbuf->buffer + (size_t)wptr * ringbuf->item_size, buffer, ringbuf->item_size);
+
+    EASY_ATOMIC_STORE(&ringbuf->write_index, data_ringbuffer_index_next(ringbuf, write_index), EASY_ATOMIC_RELEASE);
+
+    return 1;
+}
+
+int easy_data_ringbuffer_get_overwrite(easy_data_ringbuffer_t *ringbuf, void *buffer)
+{
+    easy_data_ringbuffer_index_t read_index;
+    easy_data_ringbuffer_index_t rptr;
+
+    /* copy, then claim the item, take the next one if the writer dropped it meanwhile */
+    do
+    {
+        read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+        if (read_index == EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_ACQUIRE))
+        {
+            return 0;
+        }
+
+        rptr = DATA_RINGBUFFER_INDEX_TO_PTR(read_index, ringbuf->total_size);
+        memcpy(buffer, ringbuf->buffer + (size_t)rptr * ringbuf->item_size, ringbuf->item_size);
+    } while (!EASY_ATOMIC_CAS(&ringbuf->read_index, &read_index, data_ringbuffer_index_next(ringbuf, read_index), EASY_ATOMIC_ACQ_REL));
+
+    return 1;
+}
+
+uint32_t easy_data_ringbuffer_take_dropped(easy_data_ringbuffer_t *ringbuf)
+{
+    return EASY_ATOMIC_EXCHANGE(&ringbuf->dropped, 0, EASY_ATOMIC_RELAXED);
+}
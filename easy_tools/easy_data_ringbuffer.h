@@ -3,6 +3,21 @@
 
 #include <stddef.h>
 #include <stdint.h>
+
+#include "easy_tools_config.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Type of the item counts and indices, the indices run up to twice the item count. */
+#if EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT
+typedef uint32_t easy_data_ringbuffer_index_t;
+#else
+typedef uint16_t easy_data_ringbuffer_index_t;
+#endif
+
 /**
  * @brief   Define a Memory RINGBUF thread safe, and can full use pool.
  * @details API 1 and 2.
@@ -15,11 +30,12 @@
  */
 typedef struct easy_data_ringbuffer
 {
-    uint16_t total_size;  /* Number of buffers */
-    uint16_t item_size;   /* Stride between elements */
-    uint16_t read_index;  /* Read. Read index */
-    uint16_t write_index; /* Write. Write index */
+    easy_data_ringbuffer_index_t total_size;  /* Number of buffers */
+    easy_data_ringbuffer_index_t item_size;   /* Stride between elements */
+    easy_data_ringbuffer_index_t read_index;  /* Read. Read index */
+    easy_data_ringbuffer_index_t write_index; /* Write. Write index */
     uint8_t *buffer;
+    uint32_t dropped; /* Items overwritten by easy_data_ringbuffer_put_overwrite before they were read */
 } easy_data_ringbuffer_t;
 
 #ifndef EASY_MROUND
@@ -81,21 +97,25 @@ static inline void easy_data_ringbuffer_reset(easy_data_ringbuffer_t *ringbuf)
 {
     ringbuf->write_index = 0;
     ringbuf->read_index = 0;
+    ringbuf->dropped = 0;
 }
 
 /**
  * @brief  Initialize the RINGBUF.
  * @param  [in] ringbuf: The ringbuf to be used.
- * @param  [in] total_size: The total size of the RINGBUF.
+ * @param  [in] total_size: The number of items, at most 32767 (or 2^31 - 1
+ *         with EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT).
+ * @param  [in] item_size: The stride between items.
  * @param  [in] buffer: The buffer to be used.
  */
-static inline void easy_data_ringbuffer_init(easy_data_ringbuffer_t *ringbuf, uint16_t total_size, uint16_t item_size, void *buffer)
+static inline void easy_data_ringbuffer_init(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t total_size, easy_data_ringbuffer_index_t item_size, void *buffer)
 {
     ringbuf->total_size = total_size;
     ringbuf->item_size = item_size;
     ringbuf->write_index = 0;
     ringbuf->read_index = 0;
-    ringbuf->buffer = buffer;
+    ringbuf->buffer = (uint8_t *)buffer;
+    ringbuf->dropped = 0;
 }
 
 /**
@@ -113,7 +133,7 @@ static inline int easy_data_ringbuffer_is_empty(easy_data_ringbuffer_t *ringbuf)
  * @param  [in] ringbuf: The ringbuf to be used.
  * @return The used size of the RINGBUF in bytes.
  */
-static inline uint16_t easy_data_ringbuffer_size(easy_data_ringbuffer_t *ringbuf)
+static inline easy_data_ringbuffer_index_t easy_data_ringbuffer_size(easy_data_ringbuffer_t *ringbuf)
 {
     return ringbuf->write_index >= ringbuf->read_index ? ringbuf->write_index - ringbuf->read_index
                                                        : (ringbuf->total_size << 1) - (ringbuf->read_index - ringbuf->write_index);
@@ -124,7 +144,7 @@ static inline uint16_t easy_data_ringbuffer_size(easy_data_ringbuffer_t *ringbuf
  * @param  [in] ringbuf: The ringbuf to be used.
  * @return The free size of the RINGBUF in bytes.
  */
-static inline uint16_t easy_data_ringbuffer_reserve_size(easy_data_ringbuffer_t *ringbuf)
+static inline easy_data_ringbuffer_index_t easy_data_ringbuffer_reserve_size(easy_data_ringbuffer_t *ringbuf)
 {
     return ringbuf->total_size - easy_data_ringbuffer_size(ringbuf);
 }
@@ -154,6 +174,35 @@ int easy_data_ringbuffer_put(easy_data_ringbuffer_t *ringbuf, void *buffer);
  */
 int easy_data_ringbuffer_get(easy_data_ringbuffer_t *ringbuf, void *buffer);
 
+/**
+ * @brief   Put data into the RINGBUF, dropping the oldest item when it is full.
+ * @details Overwrite mode, the writer never fails. The read index is moved
+ *   with a CAS, so a reader using easy_data_ringbuffer_get_overwrite on another
+ *   thread notices it was overrun. The dropped items are counted, see
+ *   easy_data_ringbuffer_take_dropped. Only one writer.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to be put into the RINGBUF.
+ * @return The number of items put into the RINGBUF.
+ */
+int easy_data_ringbuffer_put_overwrite(easy_data_ringbuffer_t *ringbuf, void *buffer);
+
+/**
+ * @brief   Get data from a RINGBUF written by easy_data_ringbuffer_put_overwrite.
+ * @details The item is copied first and claimed with a CAS on the read index,
+ *   if the writer dropped it meanwhile the next one is copied. Only one reader.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to get the item.
+ * @return The number of items get from the RINGBUF.
+ */
+int easy_data_ringbuffer_get_overwrite(easy_data_ringbuffer_t *ringbuf, void *buffer);
+
+/**
+ * @brief  Returns the items dropped by easy_data_ringbuffer_put_overwrite
+ *         since the last call, non-zero means the reader was overrun.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ */
+uint32_t easy_data_ringbuffer_take_dropped(easy_data_ringbuffer_t *ringbuf);
+
 /**
  * @brief   Non-destructive: Allocate buffer from named queue
  * @details API 1.
@@ -162,7 +211,7 @@ int easy_data_ringbuffer_get(easy_data_ringbuffer_t *ringbuf, void *buffer);
  * called afterwards
  * @return  Index of newly allocated buffer; only valid if mem != NULL
  */
-int easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem);
+easy_data_ringbuffer_index_t easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem);
 
 /**
  * @brief   Atomically commit a previously allocated buffer
@@ -170,7 +219,49 @@ int easy_data_ringbuffer_enqueue_get(easy_data_ringbuffer_t *ringbuf, void **mem
  *   The buffer should have been allocated using MRINGBUF_ENQUEUE_GET
  * @param idx[in]  Index one-ahead of previously allocated buffer
  */
-void easy_data_ringbuffer_enqueue(easy_data_ringbuffer_t *ringbuf, uint16_t write_index);
+void easy_data_ringbuffer_enqueue(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t write_index);
+
+/**
+ * @brief   Put up to n items into the RINGBUF.
+ * @details One size check, at most two memcpy and one write index update for
+ *   the whole batch.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The items, back to back with a stride of item_size.
+ * @param  [in] n: The number of items.
+ * @return The number of items put into the RINGBUF.
+ */
+easy_data_ringbuffer_index_t easy_data_ringbuffer_put_n(easy_data_ringbuffer_t *ringbuf, const void *buffer, easy_data_ringbuffer_index_t n);
+
+/**
+ * @brief  Get up to n items from the RINGBUF, the batch version of
+ *         easy_data_ringbuffer_get.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to get the items, NULL to drop them.
+ * @param  [in] n: The number of items.
+ * @return The number of items get from the RINGBUF.
+ */
+easy_data_ringbuffer_index_t easy_data_ringbuffer_get_n(easy_data_ringbuffer_t *ringbuf, void *buffer, easy_data_ringbuffer_index_t n);
+
+/**
+ * @brief   Non-destructive: Allocate up to n buffers to be filled in place.
+ * @details The batch version of easy_data_ringbuffer_enqueue_get, the buffers
+ *   wrap at the end of the RINGBUF so they come as two runs, count[1] is 0
+ *   unless they wrap. Commit with easy_data_ringbuffer_enqueue_n().
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] n: The number of buffers wanted.
+ * @param  [out] mem: The first buffer of each run.
+ * @param  [out] count: The number of buffers of each run.
+ * @return The number of buffers allocated, count[0] + count[1].
+ */
+easy_data_ringbuffer_index_t easy_data_ringbuffer_enqueue_get_n(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t n, void *mem[2],
+                                                                easy_data_ringbuffer_index_t count[2]);
+
+/**
+ * @brief  Commit the first n buffers allocated by easy_data_ringbuffer_enqueue_get_n.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] n: The number of buffers filled.
+ */
+void easy_data_ringbuffer_enqueue_n(easy_data_ringbuffer_t *ringbuf, easy_data_ringbuffer_index_t n);
 
 /**
  * @brief  Peek data from the RINGBUF, but not dequeue.
@@ -185,4 +276,9 @@ void *easy_data_ringbuffer_dequeue_peek(easy_data_ringbuffer_t *ringbuf);
  */
 void easy_data_ringbuffer_dequeue(easy_data_ringbuffer_t *ringbuf);
 
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _EASY_DATA_RINGBUFFER_H_ */
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_frame_ring.h"
+#include "easy_tools_common.h"
+
+/* Header of the padding at the end of the buffer in contiguous mode. */
+#define FRAME_RING_PAD UINT32_MAX
+
+#define FRAME_RING_ALIGN_MASK ((uint32_t)EASY_FRAME_RING_HEADER_SIZE - 1)
+
+void easy_frame_ring_init(easy_frame_ring_t *frame_ring, uint32_t total_size, uint8_t *buffer, int contiguous)
+{
+    /* frames and the buffer end are aligned, so a header never wraps */
+    easy_ringbuffer_init(&frame_ring->ring, total_size & ~FRAME_RING_ALIGN_MASK, buffer);
+    frame_ring->frame = NULL;
+    frame_ring->frame_skip = 0;
+    frame_ring->frame_max = 0;
+    frame_ring->contiguous = contiguous;
+}
+
+int easy_frame_ring_reserve(easy_frame_ring_t *frame_ring, uint32_t len, easy_ringbuffer_span_t spans[2])
+{
+    easy_ringbuffer_span_t free_spans[2];
+    uint32_t frame_size = EASY_FRAME_RING_FRAME_SIZE(len);
+    uint32_t free_size = easy_ringbuffer_write_acquire_spans(&frame_ring->ring, free_spans, UINT32_MAX);
+
+    frame_ring->frame = NULL;
+    if (len > frame_ring->ring.total_size || frame_size > free_size)
+    {
+        return -1;
+    }
+
+    frame_ring->frame_skip = 0;
+    if (free_spans[0].len >= frame_size || !frame_ring->contiguous)
+    {
+        frame_ring->frame = free_spans[0].ptr;
+    }
+    else if (free_spans[1].len >= frame_size)
+    {
+        /* skip the end of the buffer, the padding header is written on commit */
+        frame_ring->frame_skip = free_spans[0].len;
+        frame_ring->frame = free_spans[1].ptr;
+        free_spans[0] = free_spans[1];
+        free_spans[1].len = 0;
+    }
+    else
+    {
+        /* Empty ring, the frame only fits from the start of the buffer: pad
+         * the end now, the reader skips it and both indices are at the start
+         * for the next reserve. */
+        if (free_size == frame_ring->ring.total_size)
+        {
+            uint32_t header = FRAME_RING_PAD;
+
+            memcpy(free_spans[0].ptr, &header, sizeof(header));
+            easy_ringbuffer_write_commit(&frame_ring->ring, free_spans[0].len);
+        }
+        return -1;
+    }
+    frame_ring->frame_max = len;
+
+    /* the header is always in the first span */
+    spans[0].ptr = frame_ring->frame + EASY_FRAME_RING_HEADER_SIZE;
+    spans[0].len = EASY_MIN(len, free_spans[0].len - EASY_FRAME_RING_HEADER_SIZE);
+    spans[1].ptr = free_spans[1].ptr;
+    spans[1].len = len - spans[0].len;
+
+    return 0;
+}
+
+int easy_frame_ring_commit(easy_frame_ring_t *frame_ring, uint32_t len)
+{
+    uint32_t header;
+
+    if (frame_ring->frame == NULL || len > frame_ring->frame_max)
+    {
+        return -1;
+    }
+
+    if (frame_ring->frame_skip)
+    {
+        header = FRAME_RING_PAD;
+        memcpy(frame_ring->ring.buffer + (frame_ring->ring.total_size - frame_ring->frame_skip), &header, sizeof(header));
+    }
+
+    header = len;
+    memcpy(frame_ring->frame, &header, sizeof(header));
+
+    /* padding, header and payload become visible at once */
+    easy_ringbuffer_write_commit(&frame_ring->ring, frame_ring->frame_skip + EASY_FRAME_RING_FRAME_SIZE(len));
+    frame_ring->frame = NULL;
+
+    return 0;
+}
+
+int32_t easy_frame_ring_peek(easy_frame_ring_t *frame_ring, easy_ringbuffer_span_t spans[2])
+{
+    easy_ringbuffer_span_t data_spans[2];
+    uint32_t header;
+
+    do
+    {
+        if (easy_ringbuffer_read_acquire_spans(&frame_ring->ring, data_spans, UINT32_MAX) == 0)
+        {
+            return -1;
+        }
+
+        memcpy(&header, data_spans[0].ptr, sizeof(header));
+        if (header == FRAME_RING_PAD)
+        {
+            easy_ringbuffer_read_release(&frame_ring->ring, data_spans[0].len);
+        }
+    } while (header == FRAME_RING_PAD);
+
+    spans[0].ptr = data_spans[0].ptr + EASY_FRAME_RING_HEADER_SIZE;
+    spans[0].len = EASY_MIN(header, data_spans[0].len - EASY_FRAME_RING_HEADER_SIZE);
+    spans[1].ptr = data_spans[1].ptr;
+    spans[1].len = header - spans[0].len;
+
+    return (int32_t)header;
+}
+
+void easy_frame_ring_release(easy_frame_ring_t *frame_ring)
+{
+    easy_ringbuffer_span_t spans[2];
+    int32_t len = easy_frame_ring_peek(frame_ring, spans);
+
+    if (len >= 0)
+    {
+        easy_ringbuffer_read_release(&frame_ring->ring, EASY_FRAME_RING_FRAME_SIZE(len));
+    }
+}
+
+int easy_frame_ring_put(easy_frame_ring_t *frame_ring, const uint8_t *buffer, uint32_t len)
+{
+    easy_ringbuffer_span_t spans[2];
+
+    if (easy_frame_ring_reserve(frame_ring, len, spans) != 0)
+    {
+        return -1;
+    }
+
+    memcpy(spans[0].ptr, buffer, spans[0].len);
+    memcpy(spans[1].ptr, buffer + spans[0].len, spans[1].len);
+
+    return easy_frame_ring_commit(frame_ring, len);
+}
+
+int32_t easy_frame_ring_get(easy_frame_ring_t *frame_ring, uint8_t *buffer, uint32_t len)
+{
+    easy_ringbuffer_span_t spans[2];
+    int32_t frame_len = easy_frame_ring_peek(frame_ring, spans);
+    uint32_t l;
+
+    if (frame_len < 0)
+    {
+        return -1;
+    }
+
+    l = EASY_MIN(len, spans[0].len);
+    memcpy(buffer, spans[0].ptr, l);
+    memcpy(buffer + l, spans[1].ptr, EASY_MIN(len - l, spans[1].len));
+
+    easy_frame_ring_release(frame_ring);
+
+    return frame_len;
+}
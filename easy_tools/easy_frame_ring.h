@@ -0,0 +1,141 @@
+#ifndef _EASY_FRAME_RING_H_
+#define _EASY_FRAME_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "easy_ringbuffer.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Every frame starts with its payload length, frames are aligned to the header size. */
+#define EASY_FRAME_RING_HEADER_SIZE sizeof(uint32_t)
+
+/* Bytes a frame of _len payload bytes takes in the ring. */
+#define EASY_FRAME_RING_FRAME_SIZE(_len) (((uint32_t)(_len) + 2 * EASY_FRAME_RING_HEADER_SIZE - 1) & ~(uint32_t)(EASY_FRAME_RING_HEADER_SIZE - 1))
+
+/**
+ * @brief   Queue of variable size frames on an easy_ringbuffer.
+ * @details A frame is a length header and the payload. The writer reserves a
+ *   frame, fills the payload in place and commits it with a single index
+ *   update, so the reader never sees a partial frame. The reader peeks the
+ *   next frame in place and releases it.
+ *   In contiguous mode a frame that does not fit before the end of the buffer
+ *   starts at the beginning, the end is skipped with a padding header, so the
+ *   payload is always one span. Otherwise the payload may wrap (two spans) and
+ *   no space is lost.
+ *   One writer and one reader, with the same rules as easy_ringbuffer.
+ */
+typedef struct easy_frame_ring
+{
+    easy_ringbuffer_t ring;
+    uint8_t *frame;      /* Write. Header of the reserved frame, NULL if none */
+    uint32_t frame_skip; /* Write. Padding to commit before the reserved frame */
+    uint32_t frame_max;  /* Write. Payload size reserved */
+    uint32_t contiguous; /* Frames never wrap */
+} easy_frame_ring_t;
+
+#define EASY_FRAME_RING_DEFINE(_name, _num, _contiguous)                                                                                                       \
+    static uint32_t _name##_data_storage[(_num) / EASY_FRAME_RING_HEADER_SIZE];                                                                                \
+    static easy_frame_ring_t _name = {.ring = {.total_size = sizeof(_name##_data_storage),                                                                     \
+                                               .write_index = 0,                                                                                               \
+                                               .read_index = 0,                                                                                                \
+                                               .buffer = (void *)_name##_data_storage,                                                                         \
+                                               .mask = EASY_RINGBUFFER_MASK(sizeof(_name##_data_storage))},                                                    \
+                                      .frame = NULL,                                                                                                           \
+                                      .contiguous = _contiguous}
+
+#define EASY_FRAME_RING_INIT(_name, _num, _contiguous) easy_frame_ring_init(&_name, sizeof(_name##_data_storage), (void *)_name##_data_storage, _contiguous)
+
+/**
+ * @brief  Initialize the frame ring.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [in] total_size: The size of the buffer, rounded down to the header
+ *         size.
+ * @param  [in] buffer: The buffer to be used, aligned to the header size.
+ * @param  [in] contiguous: 1 to pad the end of the buffer so frames never wrap.
+ */
+void easy_frame_ring_init(easy_frame_ring_t *frame_ring, uint32_t total_size, uint8_t *buffer, int contiguous);
+
+/**
+ * @brief  Returns the bytes used by the frames, headers and padding included.
+ */
+static inline uint32_t easy_frame_ring_size(easy_frame_ring_t *frame_ring)
+{
+    return easy_ringbuffer_size(&frame_ring->ring);
+}
+
+/**
+ * @brief  Check if there is no frame.
+ */
+static inline int easy_frame_ring_is_empty(easy_frame_ring_t *frame_ring)
+{
+    return easy_ringbuffer_is_empty(&frame_ring->ring);
+}
+
+/**
+ * @brief   Reserve a frame to be filled in place.
+ * @details Header and payload are reserved together, nothing is visible to the
+ *   reader until easy_frame_ring_commit. A new reserve drops the previous one.
+ *   In contiguous mode a frame that only fits from the start of an empty ring
+ *   is refused once, the end of the buffer is padded instead: the reserve
+ *   succeeds after the reader has skipped the padding (a peek or get on the
+ *   empty ring), so any frame of up to total_size bytes gets through.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [in] len: The max payload length.
+ * @param  [out] spans: The payload space, spans[1] is empty unless the payload
+ *         wraps, which never happens in contiguous mode.
+ * @return 0 on success, -1 if there is no room.
+ */
+int easy_frame_ring_reserve(easy_frame_ring_t *frame_ring, uint32_t len, easy_ringbuffer_span_t spans[2]);
+
+/**
+ * @brief  Commit the reserved frame.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [in] len: The payload length written, no more than the reserved one.
+ * @return 0 on success, -1 if no frame is reserved or len is too big.
+ */
+int easy_frame_ring_commit(easy_frame_ring_t *frame_ring, uint32_t len);
+
+/**
+ * @brief  Peek the next frame without copying.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [out] spans: The payload, spans[1] is empty unless it wraps.
+ * @return The payload length, -1 if there is no frame.
+ */
+int32_t easy_frame_ring_peek(easy_frame_ring_t *frame_ring, easy_ringbuffer_span_t spans[2]);
+
+/**
+ * @brief  Drop the next frame, after easy_frame_ring_peek.
+ * @param  [in] frame_ring: The frame ring to be used.
+ */
+void easy_frame_ring_release(easy_frame_ring_t *frame_ring);
+
+/**
+ * @brief  Copy a frame in, reserve + copy + commit.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [in] buffer: The payload.
+ * @param  [in] len: The payload length.
+ * @return 0 on success, -1 if there is no room.
+ */
+int easy_frame_ring_put(easy_frame_ring_t *frame_ring, const uint8_t *buffer, uint32_t len);
+
+/**
+ * @brief  Copy the next frame out and drop it, peek + copy + release.
+ * @param  [in] frame_ring: The frame ring to be used.
+ * @param  [in] buffer: The buffer to get the payload.
+ * @param  [in] len: The length of the buffer, a longer payload is truncated.
+ * @return The payload length (more than len when truncated), -1 if there is
+ *         no frame.
+ */
+int32_t easy_frame_ring_get(easy_frame_ring_t *frame_ring, uint8_t *buffer, uint32_t len);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EASY_FRAME_RING_H_ */
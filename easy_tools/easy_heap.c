@@ -1,55 +1,47 @@
 #include "easy_heap.h"
+#include "easy_tools_common.h"
 #include "easy_tools_config.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
-#if EASY_CONFIG_FUNCTION_HEAP
+#if EASY_CONFIG_FUNCTION_HEAP && !EASY_CONFIG_HEAP_TLSF
 
-#define BLOCK_ALLOCATED         0x80000000
-#define portBYTE_ALIGNMENT      4
+#define BLOCK_ALLOCATED         ((easy_heap_size_t)1 << (sizeof(easy_heap_size_t) * 8 - 1))
+#define portBYTE_ALIGNMENT      EASY_CONFIG_HEAP_BYTE_ALIGNMENT
 #define portBYTE_ALIGNMENT_MASK (portBYTE_ALIGNMENT - 1)
-#define HEAP_STRUCT_SIZE        sizeof(BlockLink_t)
-#define heapMINIMUM_BLOCK_SIZE  ((uint32_t)(HEAP_STRUCT_SIZE << 1))
+#define HEAP_STRUCT_SIZE        ((easy_heap_size_t)((sizeof(BlockLink_t) + portBYTE_ALIGNMENT_MASK) & ~portBYTE_ALIGNMENT_MASK))
+#define heapMINIMUM_BLOCK_SIZE  ((easy_heap_size_t)(HEAP_STRUCT_SIZE << 1))
 
-/* Define the linked list structure.  This is used to link free blocks in order
- * of their memory address. */
-typedef struct A_BLOCK_LINK
-{
-    struct A_BLOCK_LINK *pxNextFreeBlock; /*<< The next free block in the list. */
-    uint32_t xBlockSize;                  /*<< The size of the free block. */
-} BlockLink_t;
-
-/* Keeps track of the number of calls to allocate and free memory as well as the
- * number of free bytes remaining, but says nothing about fragmentation. */
-static BlockLink_t xStart = {0}, *pxEnd = 0;
+/* The linked list structure is defined in easy_heap.h, free blocks are linked
+ * in order of their memory address. */
+typedef easy_heap_block_link_t BlockLink_t;
 
-static struct xHeapStats
-{
-    uintptr_t xHeapAddress;
-    uint32_t xHeapSize;
-
-    uint32_t xFreeBytesRemaining;
-    uint32_t xMinimumEverFreeBytesRemaining;
-    uint32_t xNumberOfSuccessfulAllocations;
-    uint32_t xNumberOfSuccessfulFrees;
-} heapstat;
+#if EASY_CONFIG_HEAP_STATS
+#define heapSTATS_RECORD(pxHeap, xHistogram, xValue) ((pxHeap)->xHistogram[easy_heap_stats_bucket(xValue)]++)
+#else
+#define heapSTATS_RECORD(pxHeap, xHistogram, xValue) ((void)(xValue))
+#endif
 
 /*
  * Inserts a block of memory that is being freed into the correct position in
  * the list of free memory blocks.  The block being freed will be merged with
  * the block in front it and/or the block behind it if the memory blocks are
- * adjacent to each other.
+ * adjacent to each other.  The walk starts at *ppxStart, which must not be
+ * behind the block, and is left at the free block holding the inserted one.
  */
-static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert)
+static uint32_t prvInsertBlockIntoFreeListFrom(easy_heap_t *pxHeap, BlockLink_t **ppxStart, BlockLink_t *pxBlockToInsert)
 { /* */
     BlockLink_t *pxIterator;
     uint8_t *puc;
+    uint32_t xWalkLength = 0;
 
     /* Iterate through the list until a block is found that has a higher address
      * than the block being inserted. */
-    for (pxIterator = &xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock)
+    for (pxIterator = *ppxStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock)
     {
         /* Nothing to do here, just iterate to the right position. */
+        xWalkLength++;
     }
 
     /* Do the block being inserted, and the block it is being inserted after
@@ -68,15 +60,21 @@ static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert)
 
     if ((puc + pxBlockToInsert->xBlockSize) == (uint8_t *)pxIterator->pxNextFreeBlock)
     {
-        if (pxIterator->pxNextFreeBlock != pxEnd)
+        if (pxIterator->pxNextFreeBlock != pxHeap->pxEnd)
         {
+            /* The next-fit rover must not be left on the merged block. */
+            if (pxHeap->pxRover == pxIterator->pxNextFreeBlock)
+            {
+                pxHeap->pxRover = pxBlockToInsert;
+            }
+
             /* Form one big block from the two blocks. */
             pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
             pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
         }
         else
         {
-            pxBlockToInsert->pxNextFreeBlock = pxEnd;
+            pxBlockToInsert->pxNextFreeBlock = pxHeap->pxEnd;
         }
     }
     else
@@ -92,43 +90,399 @@ static void prvInsertBlockIntoFreeList(BlockLink_t *pxBlockToInsert)
     {
         pxIterator->pxNextFreeBlock = pxBlockToInsert;
     }
+
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    if (pxBlockToInsert->pxNextFreeBlock == pxHeap->pxEnd)
+    {
+        pxHeap->pxLastFreeBlock = pxBlockToInsert;
+    }
+#endif
+
+    /* A block at a higher address may start the walk from here. */
+    *ppxStart = pxBlockToInsert;
+
+    return xWalkLength;
+}
+
+static uint32_t prvInsertBlockIntoFreeList(easy_heap_t *pxHeap, BlockLink_t *pxBlockToInsert)
+{
+    BlockLink_t *pxStart = &pxHeap->xStart;
+
+    return prvInsertBlockIntoFreeListFrom(pxHeap, &pxStart, pxBlockToInsert);
+}
+
+#if (portBYTE_ALIGNMENT & portBYTE_ALIGNMENT_MASK) != 0
+#error "EASY_CONFIG_HEAP_BYTE_ALIGNMENT must be a power of two."
+#endif
+
+/*
+ * Returns the block size needed for xWantedSize bytes of payload, 0 if the
+ * size can not be represented.
+ */
+static easy_heap_size_t prvBlockSizeFor(easy_heap_size_t xWantedSize)
+{
+    if (xWantedSize > (BLOCK_ALLOCATED - HEAP_STRUCT_SIZE - portBYTE_ALIGNMENT))
+    {
+        return 0;
+    }
+
+    return (xWantedSize + HEAP_STRUCT_SIZE + portBYTE_ALIGNMENT_MASK) & ~portBYTE_ALIGNMENT_MASK;
+}
+
+/*
+ * Gives the tail of an allocated block back to the free list if it is large
+ * enough to be a block of its own.
+ */
+static void prvTrimBlock(easy_heap_t *pxHeap, BlockLink_t *pxBlock, easy_heap_size_t xWantedSize)
+{
+    easy_heap_size_t xBlockSize = pxBlock->xBlockSize & ~BLOCK_ALLOCATED;
+    BlockLink_t *pxNewBlockLink;
+
+    if ((xBlockSize - xWantedSize) > heapMINIMUM_BLOCK_SIZE)
+    {
+        pxNewBlockLink = (void *)(((uint8_t *)pxBlock) + xWantedSize);
+        pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+        pxBlock->xBlockSize = xWantedSize | BLOCK_ALLOCATED;
+
+        pxHeap->xFreeBytesRemaining += pxNewBlockLink->xBlockSize;
+        prvInsertBlockIntoFreeList(pxHeap, pxNewBlockLink);
+    }
+}
+
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+/*
+ * Carves a block from the bump region at the end of the heap, it is used when
+ * the free list search gives up.  A freed block in front of the region goes
+ * back to it, any other one goes to the free list.
+ */
+static void *prvBumpMalloc(easy_heap_t *pxHeap, easy_heap_size_t xWantedSize)
+{
+    BlockLink_t *pxBlock = (void *)pxHeap->pucBumpNext;
+    easy_heap_size_t xRemain = (easy_heap_size_t)((uint8_t *)pxHeap->pxEnd - pxHeap->pucBumpNext);
+
+    if (xWantedSize > xRemain)
+    {
+        return 0;
+    }
+
+    /* A tail too small to be a block is handed out as well. */
+    if ((xRemain - xWantedSize) < heapMINIMUM_BLOCK_SIZE)
+    {
+        xWantedSize = xRemain;
+    }
+
+    pxHeap->pucBumpNext += xWantedSize;
+    pxHeap->xFreeBytesRemaining -= xWantedSize;
+    if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
+    {
+        pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
+    }
+
+    pxBlock->xBlockSize = xWantedSize | BLOCK_ALLOCATED;
+    pxBlock->pxNextFreeBlock = 0;
+
+    return (uint8_t *)pxBlock + HEAP_STRUCT_SIZE;
+}
+
+/*
+ * A freed block right in front of the bump region goes back to it, so blocks
+ * carved from the region and freed again do not use it up.  Returns 1 if the
+ * block was taken.
+ */
+static int prvBumpFree(easy_heap_t *pxHeap, BlockLink_t *pxBlock)
+{
+    if ((uint8_t *)pxBlock + pxBlock->xBlockSize != pxHeap->pucBumpNext)
+    {
+        return 0;
+    }
+
+    pxHeap->pucBumpNext = (uint8_t *)pxBlock;
+    return 1;
+}
+
+/*
+ * Gives the rest of the bump region to the free list, merged with the last
+ * free block if they touch, so a request larger than both of them apart can
+ * still be served.  It is only used when the region can not serve a request,
+ * the last free block is tracked so it takes no walk.
+ */
+static void prvBumpReclaim(easy_heap_t *pxHeap)
+{
+    BlockLink_t *pxIterator = pxHeap->pxLastFreeBlock;
+    BlockLink_t *pxBlock = (void *)pxHeap->pucBumpNext;
+    easy_heap_size_t xRemain = (easy_heap_size_t)((uint8_t *)pxHeap->pxEnd - pxHeap->pucBumpNext);
+
+    if (xRemain == 0)
+    {
+        return;
+    }
+
+    if ((uint8_t *)pxIterator + pxIterator->xBlockSize == pxHeap->pucBumpNext)
+    {
+        pxIterator->xBlockSize += xRemain;
+    }
+    else if (xRemain >= heapMINIMUM_BLOCK_SIZE)
+    {
+        pxBlock->xBlockSize = xRemain;
+        pxBlock->pxNextFreeBlock = pxHeap->pxEnd;
+        pxIterator->pxNextFreeBlock = pxBlock;
+        pxHeap->pxLastFreeBlock = pxBlock;
+    }
+    else
+    {
+        return;
+    }
+
+    pxHeap->pucBumpNext = (uint8_t *)pxHeap->pxEnd;
+}
+
+/*
+ * Carves a block from the end of the last free block, it needs no walk as the
+ * last free block stays in the list.  Returns 0 if it can not keep a block of
+ * its own.
+ */
+static void *prvTailMalloc(easy_heap_t *pxHeap, easy_heap_size_t xWantedSize)
+{
+    BlockLink_t *pxLast = pxHeap->pxLastFreeBlock;
+    BlockLink_t *pxBlock;
+
+    if (pxLast == &pxHeap->xStart || pxLast->xBlockSize < xWantedSize + heapMINIMUM_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    pxLast->xBlockSize -= xWantedSize;
+    pxBlock = (void *)((uint8_t *)pxLast + pxLast->xBlockSize);
+
+    pxHeap->xFreeBytesRemaining -= xWantedSize;
+    if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
+    {
+        pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
+    }
+
+    pxBlock->xBlockSize = xWantedSize | BLOCK_ALLOCATED;
+    pxBlock->pxNextFreeBlock = 0;
+
+    return (uint8_t *)pxBlock + HEAP_STRUCT_SIZE;
 }
+#endif
 
-/* Create a couple of list links to mark the start and end of the list. */
+/*
+ * Appends the physically next block to an allocated block if it is free and
+ * the two of them hold at least xWantedSize bytes.  Returns 1 if merged.
+ */
+static int prvGrowBlock(easy_heap_t *pxHeap, BlockLink_t *pxBlock, easy_heap_size_t xWantedSize)
+{
+    easy_heap_size_t xBlockSize = pxBlock->xBlockSize & ~BLOCK_ALLOCATED;
+    BlockLink_t *pxNext = (void *)(((uint8_t *)pxBlock) + xBlockSize);
+    BlockLink_t *pxIterator;
+
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    /* The bump region has no block header. */
+    if ((uint8_t *)pxNext == pxHeap->pucBumpNext)
+    {
+        return 0;
+    }
+#endif
+
+    if (pxNext == pxHeap->pxEnd || (pxNext->xBlockSize & BLOCK_ALLOCATED) != 0 || (xBlockSize + pxNext->xBlockSize) < xWantedSize)
+    {
+        return 0;
+    }
+
+    /* The free list is sorted by address, so the block before pxNext in the
+     * list is found by walking up to it. */
+    for (pxIterator = &pxHeap->xStart; pxIterator->pxNextFreeBlock < pxNext; pxIterator = pxIterator->pxNextFreeBlock)
+    {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    if (pxIterator->pxNextFreeBlock != pxNext)
+    {
+        return 0;
+    }
+
+    if (pxHeap->pxRover == pxNext)
+    {
+        pxHeap->pxRover = pxIterator;
+    }
+    pxIterator->pxNextFreeBlock = pxNext->pxNextFreeBlock;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    if (pxHeap->pxLastFreeBlock == pxNext)
+    {
+        pxHeap->pxLastFreeBlock = pxIterator;
+    }
+#endif
+    pxHeap->xFreeBytesRemaining -= pxNext->xBlockSize;
+    if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
+    {
+        pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
+    }
+    pxBlock->xBlockSize = (xBlockSize + pxNext->xBlockSize) | BLOCK_ALLOCATED;
+
+    return 1;
+}
+
+/*
+ * Searches the free list from the block after pxPreviousBlock up to pxStop
+ * (not included) for the first block of at least xWantedSize bytes.  Returns
+ * the block in front of the one found, 0 if none.
+ */
+static BlockLink_t *prvFindFirstFit(BlockLink_t *pxPreviousBlock, BlockLink_t *pxStop, easy_heap_size_t xWantedSize, uint32_t *pxWalkLength, uint32_t xWalkLimit)
+{
+    BlockLink_t *pxBlock = pxPreviousBlock->pxNextFreeBlock;
+
+    EASY_UNUSED(xWalkLimit);
+
+    while (pxBlock != pxStop)
+    {
+        if (pxBlock->xBlockSize >= xWantedSize)
+        {
+            return pxPreviousBlock;
+        }
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        /* Give up the search, the bump region serves the request. */
+        if (*pxWalkLength >= xWalkLimit)
+        {
+            return 0;
+        }
+#endif
+        pxPreviousBlock = pxBlock;
+        pxBlock = pxBlock->pxNextFreeBlock;
+        (*pxWalkLength)++;
+    }
+
+    return 0;
+}
+
+/*
+ * Same as prvFindFirstFit, but looks for the smallest block which fits.  An
+ * exact fit ends the search early, the walk limit ends it with the best block
+ * seen so far.
+ */
+static BlockLink_t *prvFindBestFit(BlockLink_t *pxPreviousBlock, BlockLink_t *pxStop, easy_heap_size_t xWantedSize, uint32_t *pxWalkLength, uint32_t xWalkLimit)
+{
+    BlockLink_t *pxBlock = pxPreviousBlock->pxNextFreeBlock;
+    BlockLink_t *pxBestPrevious = 0;
+    easy_heap_size_t xBestSize = 0;
+
+    EASY_UNUSED(xWalkLimit);
+
+    while (pxBlock != pxStop)
+    {
+        if (pxBlock->xBlockSize >= xWantedSize && (pxBestPrevious == 0 || pxBlock->xBlockSize < xBestSize))
+        {
+            pxBestPrevious = pxPreviousBlock;
+            xBestSize = pxBlock->xBlockSize;
+            if (xBestSize == xWantedSize)
+            {
+                break;
+            }
+        }
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        if (*pxWalkLength >= xWalkLimit)
+        {
+            break;
+        }
+#endif
+        pxPreviousBlock = pxBlock;
+        pxBlock = pxBlock->pxNextFreeBlock;
+        (*pxWalkLength)++;
+    }
+
+    return pxBestPrevious;
+}
 
 /*-----------------------------------------------------------*/
 
-void *easy_heap_malloc(uint32_t xWantedSize)
+void easy_heap_instance_set_policy(easy_heap_t *pxHeap, easy_heap_policy_t xPolicy)
+{
+    pxHeap->xPolicy = xPolicy;
+    pxHeap->pxRover = &pxHeap->xStart;
+}
+
+void *easy_heap_instance_malloc(easy_heap_t *pxHeap, easy_heap_size_t xWantedSize)
 {
     BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
     void *pvReturn = 0;
+    easy_heap_size_t xRequestedSize = xWantedSize;
+    uint32_t xWalkLength = 1;
 
-    xWantedSize = (xWantedSize + HEAP_STRUCT_SIZE + portBYTE_ALIGNMENT_MASK) & ~portBYTE_ALIGNMENT_MASK;
-
-    if (xWantedSize <= heapstat.xFreeBytesRemaining)
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    if (EASY_ATOMIC_LOAD(&pxHeap->pvPendingFree, EASY_ATOMIC_RELAXED) != NULL)
     {
-        /* Traverse the list from the start (lowest address) block until
-         * one  of adequate size is found. */
-        pxPreviousBlock = &xStart;
-        pxBlock = xStart.pxNextFreeBlock;
+        easy_heap_instance_collect(pxHeap);
+    }
+#endif
 
-        while ((pxBlock->xBlockSize < xWantedSize) && (pxBlock->pxNextFreeBlock != 0))
+    xWantedSize = prvBlockSizeFor(xWantedSize);
+
+    if (xWantedSize != 0 && xWantedSize <= pxHeap->xFreeBytesRemaining)
+    {
+        if (pxHeap->xPolicy == EASY_HEAP_POLICY_BEST_FIT)
         {
-            pxPreviousBlock = pxBlock;
-            pxBlock = pxBlock->pxNextFreeBlock;
+            pxPreviousBlock = prvFindBestFit(&pxHeap->xStart, pxHeap->pxEnd, xWantedSize, &xWalkLength, EASY_CONFIG_HEAP_WALK_LIMIT);
         }
+        else if (pxHeap->xPolicy == EASY_HEAP_POLICY_NEXT_FIT)
+        {
+            /* Go on from the last allocation, then wrap around up to it. */
+            pxPreviousBlock = prvFindFirstFit(pxHeap->pxRover, pxHeap->pxEnd, xWantedSize, &xWalkLength, EASY_CONFIG_HEAP_WALK_LIMIT);
+            if (pxPreviousBlock == 0 && pxHeap->pxRover != &pxHeap->xStart)
+            {
+                pxPreviousBlock = prvFindFirstFit(&pxHeap->xStart, pxHeap->pxRover->pxNextFreeBlock, xWantedSize, &xWalkLength, EASY_CONFIG_HEAP_WALK_LIMIT);
+            }
+        }
+        else
+        {
+            /* Traverse the list from the start (lowest address) block until
+             * one  of adequate size is found. */
+            pxPreviousBlock = prvFindFirstFit(&pxHeap->xStart, pxHeap->pxEnd, xWantedSize, &xWalkLength, EASY_CONFIG_HEAP_WALK_LIMIT);
+        }
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        if (pxPreviousBlock == 0)
+        {
+            pvReturn = prvBumpMalloc(pxHeap, xWantedSize);
+            if (pvReturn == 0)
+            {
+                /* The bump region is used up, its rest joins the last free
+                 * block and the request is carved from there. Nothing else is
+                 * walked, so malloc fails rather than break the bound. */
+                prvBumpReclaim(pxHeap);
+                pvReturn = prvTailMalloc(pxHeap, xWantedSize);
+#if EASY_CONFIG_HEAP_WALK_FALLBACK
+                if (pvReturn == 0)
+                {
+                    pxPreviousBlock = prvFindFirstFit(&pxHeap->xStart, pxHeap->pxEnd, xWantedSize, &xWalkLength, UINT32_MAX);
+                }
+#endif
+            }
+        }
+#endif
+        heapSTATS_RECORD(pxHeap, xMallocWalkHistogram, xWalkLength);
 
         /* If the end marker was reached then a block of adequate size
          * was  not found. */
-        if (pxBlock != pxEnd)
+        if (pxPreviousBlock != 0)
         {
+            pxBlock = pxPreviousBlock->pxNextFreeBlock;
+
             /* Return the memory space pointed to - jumping over the
              * BlockLink_t structure at its start. */
-            pvReturn = (uint8_t *)pxPreviousBlock->pxNextFreeBlock + HEAP_STRUCT_SIZE;
+            pvReturn = (uint8_t *)pxBlock + HEAP_STRUCT_SIZE;
 
             /* This block is being returned for use so must be taken out
              * of the list of free blocks. */
             pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+            if (pxHeap->pxLastFreeBlock == pxBlock)
+            {
+                pxHeap->pxLastFreeBlock = pxPreviousBlock;
+            }
+#endif
+            if (pxHeap->xPolicy == EASY_HEAP_POLICY_NEXT_FIT || pxHeap->pxRover == pxBlock)
+            {
+                pxHeap->pxRover = pxPreviousBlock;
+            }
 
             /* If the block is larger than required it can be split into
              * two. */
@@ -146,33 +500,39 @@ void *easy_heap_malloc(uint32_t xWantedSize)
                 pxBlock->xBlockSize = xWantedSize;
 
                 /* Insert the new block into the list of free blocks. */
-                prvInsertBlockIntoFreeList(pxNewBlockLink);
+                prvInsertBlockIntoFreeList(pxHeap, pxNewBlockLink);
             }
 
-            heapstat.xFreeBytesRemaining -= pxBlock->xBlockSize;
+            pxHeap->xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-            if (heapstat.xFreeBytesRemaining < heapstat.xMinimumEverFreeBytesRemaining)
+            if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
             {
-                heapstat.xMinimumEverFreeBytesRemaining = heapstat.xFreeBytesRemaining;
+                pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
             }
 
             /* The block is being returned - it is allocated and owned
              * by the application and has no "next" block. */
             pxBlock->xBlockSize |= BLOCK_ALLOCATED;
             pxBlock->pxNextFreeBlock = 0;
-            heapstat.xNumberOfSuccessfulAllocations++;
         }
     }
 
+    if (pvReturn != 0)
+    {
+        pxHeap->xNumberOfSuccessfulAllocations++;
+        heapSTATS_RECORD(pxHeap, xAllocSizeHistogram, xRequestedSize);
+    }
+
     return pvReturn;
 }
 
 /*-----------------------------------------------------------*/
 
-void easy_heap_free(void *pv)
+void easy_heap_instance_free(easy_heap_t *pxHeap, void *pv)
 {
     uint8_t *puc = (uint8_t *)pv;
     BlockLink_t *pxLink;
+    uint32_t xWalkLength;
 
     if (pv != 0)
     {
@@ -193,71 +553,387 @@ void easy_heap_free(void *pv)
             if (pxLink->pxNextFreeBlock == 0)
             {
                 /* Add this block to the list of free blocks. */
-                heapstat.xFreeBytesRemaining += pxLink->xBlockSize;
-                heapstat.xNumberOfSuccessfulFrees++;
-                prvInsertBlockIntoFreeList(((BlockLink_t *)pxLink));
+                pxHeap->xFreeBytesRemaining += pxLink->xBlockSize;
+                pxHeap->xNumberOfSuccessfulFrees++;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+                if (prvBumpFree(pxHeap, pxLink))
+                {
+                    return;
+                }
+#endif
+                xWalkLength = prvInsertBlockIntoFreeList(pxHeap, ((BlockLink_t *)pxLink));
+                heapSTATS_RECORD(pxHeap, xFreeWalkHistogram, xWalkLength);
             }
         }
     }
 }
 
-uint32_t easy_heap_get_remain_size(void)
+/*-----------------------------------------------------------*/
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+/*
+ * Merges two lists of blocks sorted by address.
+ */
+static BlockLink_t *prvMergeBlockLists(BlockLink_t *pxA, BlockLink_t *pxB)
 {
-    return heapstat.xFreeBytesRemaining;
+    BlockLink_t xHead;
+    BlockLink_t *pxTail = &xHead;
+
+    while (pxA != 0 && pxB != 0)
+    {
+        if (pxA < pxB)
+        {
+            pxTail->pxNextFreeBlock = pxA;
+            pxA = pxA->pxNextFreeBlock;
+        }
+        else
+        {
+            pxTail->pxNextFreeBlock = pxB;
+            pxB = pxB->pxNextFreeBlock;
+        }
+        pxTail = pxTail->pxNextFreeBlock;
+    }
+    pxTail->pxNextFreeBlock = (pxA != 0) ? pxA : pxB;
+
+    return xHead.pxNextFreeBlock;
 }
 
-int easy_heap_check_empty(void)
+/*
+ * Sorts a list of blocks by address with a bottom-up merge sort, slot i holds
+ * a sorted run of 2^i blocks, so no recursion nor extra memory is needed.
+ */
+static BlockLink_t *prvSortBlockList(BlockLink_t *pxList)
 {
-    return heapstat.xHeapSize == heapstat.xFreeBytesRemaining + HEAP_STRUCT_SIZE;
+    BlockLink_t *pxRuns[sizeof(void *) * 8] = {0};
+    BlockLink_t *pxRun;
+    int i;
+
+    while (pxList != 0)
+    {
+        pxRun = pxList;
+        pxList = pxList->pxNextFreeBlock;
+        pxRun->pxNextFreeBlock = 0;
+
+        for (i = 0; pxRuns[i] != 0; i++)
+        {
+            pxRun = prvMergeBlockLists(pxRuns[i], pxRun);
+            pxRuns[i] = 0;
+        }
+        pxRuns[i] = pxRun;
+    }
+
+    pxRun = 0;
+    for (i = 0; i < (int)(sizeof(pxRuns) / sizeof(pxRuns[0])); i++)
+    {
+        if (pxRuns[i] != 0)
+        {
+            pxRun = prvMergeBlockLists(pxRuns[i], pxRun);
+        }
+    }
+
+    return pxRun;
+}
+
+void easy_heap_instance_free_deferred(easy_heap_t *pxHeap, void *pv)
+{
+    BlockLink_t *pxLink;
+    void *pvHead;
+
+    if (pv == 0)
+    {
+        return;
+    }
+
+    /* The pending blocks are linked through pxNextFreeBlock, it is 0 for
+     * allocated blocks and set again when the block joins the free list.
+     * Clearing BLOCK_ALLOCATED marks the block pending, so a block freed twice
+     * (or a block that is not allocated) is never pushed again. */
+    pxLink = (void *)((uint8_t *)pv - HEAP_STRUCT_SIZE);
+    if ((EASY_ATOMIC_FETCH_AND(&pxLink->xBlockSize, ~BLOCK_ALLOCATED, EASY_ATOMIC_RELAXED) & BLOCK_ALLOCATED) == 0)
+    {
+        return;
+    }
+
+    pvHead = EASY_ATOMIC_LOAD(&pxHeap->pvPendingFree, EASY_ATOMIC_RELAXED);
+    do
+    {
+        pxLink->pxNextFreeBlock = pvHead;
+    } while (!EASY_ATOMIC_CAS(&pxHeap->pvPendingFree, &pvHead, pxLink, EASY_ATOMIC_RELEASE));
 }
 
-void easy_heap_init(uint32_t *heap, uint32_t size)
+void easy_heap_instance_collect(easy_heap_t *pxHeap)
+{
+    BlockLink_t *pxBlock = EASY_ATOMIC_EXCHANGE(&pxHeap->pvPendingFree, NULL, EASY_ATOMIC_ACQUIRE);
+    BlockLink_t *pxIterator = &pxHeap->xStart;
+    BlockLink_t *pxNext;
+    uint32_t xWalkLength;
+
+    /* In address order every insert goes on from the previous one, so the
+     * whole batch takes one walk of the free list. */
+    pxBlock = prvSortBlockList(pxBlock);
+    while (pxBlock != 0)
+    {
+        pxNext = pxBlock->pxNextFreeBlock;
+        /* BLOCK_ALLOCATED was cleared by easy_heap_instance_free_deferred. */
+        pxHeap->xFreeBytesRemaining += pxBlock->xBlockSize;
+        pxHeap->xNumberOfSuccessfulFrees++;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        if (prvBumpFree(pxHeap, pxBlock))
+        {
+            pxBlock = pxNext;
+            continue;
+        }
+#endif
+        xWalkLength = prvInsertBlockIntoFreeListFrom(pxHeap, &pxIterator, pxBlock);
+        heapSTATS_RECORD(pxHeap, xFreeWalkHistogram, xWalkLength);
+        pxBlock = pxNext;
+    }
+}
+#endif
+
+/*-----------------------------------------------------------*/
+
+void *easy_heap_instance_realloc(easy_heap_t *pxHeap, void *pv, easy_heap_size_t xWantedSize)
+{
+    BlockLink_t *pxBlock;
+    easy_heap_size_t xBlockSize;
+    void *pvReturn;
+
+    if (pv == 0)
+    {
+        return easy_heap_instance_malloc(pxHeap, xWantedSize);
+    }
+
+    if (xWantedSize == 0)
+    {
+        easy_heap_instance_free(pxHeap, pv);
+        return 0;
+    }
+
+    pxBlock = (void *)((uint8_t *)pv - HEAP_STRUCT_SIZE);
+    xBlockSize = prvBlockSizeFor(xWantedSize);
+    if ((pxBlock->xBlockSize & BLOCK_ALLOCATED) == 0 || xBlockSize == 0)
+    {
+        return 0;
+    }
+
+    /* Shrink, or grow into the free block behind, without moving the data. */
+    if ((pxBlock->xBlockSize & ~BLOCK_ALLOCATED) >= xBlockSize || prvGrowBlock(pxHeap, pxBlock, xBlockSize))
+    {
+        prvTrimBlock(pxHeap, pxBlock, xBlockSize);
+        return pv;
+    }
+
+    pvReturn = easy_heap_instance_malloc(pxHeap, xWantedSize);
+    if (pvReturn != 0)
+    {
+        memcpy(pvReturn, pv, (pxBlock->xBlockSize & ~BLOCK_ALLOCATED) - HEAP_STRUCT_SIZE);
+        easy_heap_instance_free(pxHeap, pv);
+    }
+
+    return pvReturn;
+}
+
+void *easy_heap_instance_aligned_alloc(easy_heap_t *pxHeap, easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize)
+{
+    BlockLink_t *pxBlock, *pxAlignedBlock;
+    easy_heap_size_t xBlockSize, xGap;
+    uintptr_t uxAligned;
+    uint8_t *pvReturn;
+
+    if (xAlignment == 0 || (xAlignment & (xAlignment - 1)) != 0)
+    {
+        return 0;
+    }
+
+    if (xAlignment <= portBYTE_ALIGNMENT)
+    {
+        return easy_heap_instance_malloc(pxHeap, xWantedSize);
+    }
+
+    /* Allocate enough to move the payload up to the boundary while leaving a
+     * valid free block in front of it. */
+    xBlockSize = prvBlockSizeFor(xWantedSize);
+    if (xBlockSize == 0 || xAlignment > (BLOCK_ALLOCATED >> 1) || xBlockSize > (BLOCK_ALLOCATED >> 1) - xAlignment - heapMINIMUM_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    pvReturn = easy_heap_instance_malloc(pxHeap, xBlockSize - HEAP_STRUCT_SIZE + xAlignment + heapMINIMUM_BLOCK_SIZE);
+    if (pvReturn == 0)
+    {
+        return 0;
+    }
+
+    pxBlock = (void *)(pvReturn - HEAP_STRUCT_SIZE);
+    if (((uintptr_t)pvReturn & (xAlignment - 1)) != 0)
+    {
+        uxAligned = ((uintptr_t)pvReturn + heapMINIMUM_BLOCK_SIZE + xAlignment - 1) & ~(uintptr_t)(xAlignment - 1);
+        xGap = (easy_heap_size_t)(uxAligned - (uintptr_t)pvReturn);
+
+        /* The leading gap becomes a free block of its own. */
+        pxAlignedBlock = (void *)(uxAligned - HEAP_STRUCT_SIZE);
+        pxAlignedBlock->xBlockSize = ((pxBlock->xBlockSize & ~BLOCK_ALLOCATED) - xGap) | BLOCK_ALLOCATED;
+        pxAlignedBlock->pxNextFreeBlock = 0;
+
+        pxBlock->xBlockSize = xGap;
+        pxHeap->xFreeBytesRemaining += xGap;
+        prvInsertBlockIntoFreeList(pxHeap, pxBlock);
+
+        pxBlock = pxAlignedBlock;
+        pvReturn = (uint8_t *)uxAligned;
+    }
+
+    prvTrimBlock(pxHeap, pxBlock, xBlockSize);
+
+    return pvReturn;
+}
+
+easy_heap_size_t easy_heap_get_usable_size(void *pv)
+{
+    BlockLink_t *pxBlock;
+
+    if (pv == 0)
+    {
+        return 0;
+    }
+
+    pxBlock = (void *)((uint8_t *)pv - HEAP_STRUCT_SIZE);
+    if ((pxBlock->xBlockSize & BLOCK_ALLOCATED) == 0)
+    {
+        return 0;
+    }
+
+    return (pxBlock->xBlockSize & ~BLOCK_ALLOCATED) - HEAP_STRUCT_SIZE;
+}
+
+void easy_heap_instance_walk(easy_heap_t *pxHeap, easy_heap_walk_cb_t pxCallback, void *pvArg)
+{
+    BlockLink_t *pxBlock = (void *)pxHeap->xHeapAddress;
+    easy_heap_size_t xBlockSize;
+
+    if (pxHeap->pxEnd == 0)
+    {
+        return;
+    }
+
+    /* The blocks cover the heap space back to back up to pxEnd. */
+    while (pxBlock != pxHeap->pxEnd)
+    {
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        /* The rest of the bump region is reported as one free block. */
+        if ((uint8_t *)pxBlock == pxHeap->pucBumpNext)
+        {
+            pxCallback((uint8_t *)pxBlock + HEAP_STRUCT_SIZE, (easy_heap_size_t)((uint8_t *)pxHeap->pxEnd - pxHeap->pucBumpNext) - HEAP_STRUCT_SIZE, 0, pvArg);
+            break;
+        }
+#endif
+        xBlockSize = pxBlock->xBlockSize & ~BLOCK_ALLOCATED;
+        if (pxCallback((uint8_t *)pxBlock + HEAP_STRUCT_SIZE, xBlockSize - HEAP_STRUCT_SIZE, (pxBlock->xBlockSize & BLOCK_ALLOCATED) != 0, pvArg) != 0)
+        {
+            break;
+        }
+        pxBlock = (void *)((uint8_t *)pxBlock + xBlockSize);
+    }
+}
+
+easy_heap_size_t easy_heap_instance_get_remain_size(easy_heap_t *pxHeap)
+{
+    return pxHeap->xFreeBytesRemaining;
+}
+
+int easy_heap_instance_check_empty(easy_heap_t *pxHeap)
+{
+    return pxHeap->xHeapFreeBytesTotal == pxHeap->xFreeBytesRemaining;
+}
+
+void easy_heap_instance_init(easy_heap_t *pxHeap, void *heap, easy_heap_size_t size)
 {
     BlockLink_t *pxFirstFreeBlock;
     uintptr_t uxAddress;
+    easy_heap_size_t xHeapSizeAligned;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    easy_heap_size_t xBumpSize;
+#endif
+
+#if EASY_CONFIG_HEAP_STATS
+    memset(pxHeap->xAllocSizeHistogram, 0, sizeof(pxHeap->xAllocSizeHistogram));
+    memset(pxHeap->xMallocWalkHistogram, 0, sizeof(pxHeap->xMallocWalkHistogram));
+    memset(pxHeap->xFreeWalkHistogram, 0, sizeof(pxHeap->xFreeWalkHistogram));
+#endif
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxAddress = ((uintptr_t)heap + portBYTE_ALIGNMENT_MASK) & ~(uintptr_t)portBYTE_ALIGNMENT_MASK;
 
     // Safety check: validate heap pointer and size
-    if (heap == NULL || size < (2 * HEAP_STRUCT_SIZE))
+    if (heap == NULL || size < (easy_heap_size_t)(uxAddress - (uintptr_t)heap) + heapMINIMUM_BLOCK_SIZE)
     {
         // Invalid parameters, do not initialize
-        heapstat.xHeapAddress = 0;
-        heapstat.xHeapSize = 0;
-        heapstat.xFreeBytesRemaining = 0;
-        heapstat.xMinimumEverFreeBytesRemaining = 0;
+        pxHeap->xStart.pxNextFreeBlock = NULL;
+        pxHeap->xStart.xBlockSize = 0;
+        pxHeap->pxEnd = NULL;
+        pxHeap->pxRover = &pxHeap->xStart;
+        pxHeap->xPolicy = EASY_CONFIG_HEAP_POLICY;
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+        pxHeap->pucBumpNext = NULL;
+        pxHeap->pxLastFreeBlock = &pxHeap->xStart;
+#endif
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+        pxHeap->pvPendingFree = NULL;
+#endif
+        pxHeap->xHeapAddress = 0;
+        pxHeap->xHeapSize = 0;
+        pxHeap->xHeapFreeBytesTotal = 0;
+        pxHeap->xFreeBytesRemaining = 0;
+        pxHeap->xMinimumEverFreeBytesRemaining = 0;
+        pxHeap->xNumberOfSuccessfulAllocations = pxHeap->xNumberOfSuccessfulFrees = 0;
         return;
     }
 
-    /* Ensure the heap starts on a correctly aligned boundary. */
-    uxAddress = (uintptr_t)heap;
+    xHeapSizeAligned = (size - (easy_heap_size_t)(uxAddress - (uintptr_t)heap)) & ~portBYTE_ALIGNMENT_MASK;
 
     /* xStart is used to hold a pointer to the first item in the list of free
      * blocks.  The void cast is used to prevent compiler warnings. */
-    xStart.pxNextFreeBlock = (void *)uxAddress;
-    xStart.xBlockSize = (uint32_t)0;
+    pxHeap->xStart.pxNextFreeBlock = (void *)uxAddress;
+    pxHeap->xStart.xBlockSize = (easy_heap_size_t)0;
+    pxHeap->pxRover = &pxHeap->xStart;
+    pxHeap->xPolicy = EASY_CONFIG_HEAP_POLICY;
 
     /* pxEnd is used to mark the end of the list of free blocks and is inserted
      * at the end of the heap space. */
-    pxEnd = (void *)(uxAddress + size - HEAP_STRUCT_SIZE);
-    pxEnd->xBlockSize = 0;
-    pxEnd->pxNextFreeBlock = 0;
+    pxHeap->pxEnd = (void *)(uxAddress + xHeapSizeAligned - HEAP_STRUCT_SIZE);
+    pxHeap->pxEnd->xBlockSize = 0;
+    pxHeap->pxEnd->pxNextFreeBlock = 0;
 
     /* To start with there is a single free block that is sized to take up the
      * entire heap space, minus the space taken by pxEnd. */
     pxFirstFreeBlock = (void *)uxAddress;
-    pxFirstFreeBlock->xBlockSize = (pxEnd - pxFirstFreeBlock) * HEAP_STRUCT_SIZE;
-    pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
+    pxFirstFreeBlock->xBlockSize = xHeapSizeAligned - HEAP_STRUCT_SIZE;
+    pxFirstFreeBlock->pxNextFreeBlock = pxHeap->pxEnd;
 
     /* Only one block exists - and it covers the entire usable heap space. */
-    heapstat.xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
-    heapstat.xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
-    heapstat.xNumberOfSuccessfulAllocations = heapstat.xNumberOfSuccessfulFrees = 0;
-
-    heapstat.xHeapAddress = uxAddress;
-    heapstat.xHeapSize = size;
-}
-
-void easy_heap_reinit(void)
-{
-    easy_heap_init((uint32_t *)heapstat.xHeapAddress, heapstat.xHeapSize);
+    pxHeap->xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    pxHeap->xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    pxHeap->xHeapFreeBytesTotal = pxFirstFreeBlock->xBlockSize;
+
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    /* The tail of the heap is kept out of the free list as the bump region,
+     * it is still counted as free space. */
+    xBumpSize = (pxFirstFreeBlock->xBlockSize / 100 * EASY_CONFIG_HEAP_BUMP_PERCENT) & ~portBYTE_ALIGNMENT_MASK;
+    if (xBumpSize < heapMINIMUM_BLOCK_SIZE || (pxFirstFreeBlock->xBlockSize - xBumpSize) < heapMINIMUM_BLOCK_SIZE)
+    {
+        xBumpSize = 0;
+    }
+    pxFirstFreeBlock->xBlockSize -= xBumpSize;
+    pxHeap->pucBumpNext = (uint8_t *)pxFirstFreeBlock + pxFirstFreeBlock->xBlockSize;
+    pxHeap->pxLastFreeBlock = pxFirstFreeBlock;
+#endif
+    pxHeap->xNumberOfSuccessfulAllocations = pxHeap->xNumberOfSuccessfulFrees = 0;
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    pxHeap->pvPendingFree = NULL;
+#endif
+
+    pxHeap->xHeapAddress = uxAddress;
+    pxHeap->xHeapSize = size;
 }
-#endif // EASY_CONFIG_FUNCTION_HEAP
+#endif // EASY_CONFIG_FUNCTION_HEAP && !EASY_CONFIG_HEAP_TLSF
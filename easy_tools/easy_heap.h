@@ -5,14 +5,271 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "easy_tools_config.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /** Define -------------------------------------------------------------------*/
+/* Type of the heap sizes, 32-bit sizes keep the block headers small on MCUs. */
+#if EASY_CONFIG_HEAP_SIZE_64BIT
+typedef size_t easy_heap_size_t;
+#else
+typedef uint32_t easy_heap_size_t;
+#endif
+
+#if EASY_CONFIG_HEAP_TLSF
+#define EASY_HEAP_TLSF_ALIGN_SIZE_LOG2 ((sizeof(void *) == 8) ? 3 : 2)
+#define EASY_HEAP_TLSF_SL_INDEX_COUNT  (1 << EASY_CONFIG_HEAP_TLSF_SL_LOG2)
+#define EASY_HEAP_TLSF_FL_INDEX_COUNT  (EASY_CONFIG_HEAP_TLSF_FL_MAX - (EASY_CONFIG_HEAP_TLSF_SL_LOG2 + EASY_HEAP_TLSF_ALIGN_SIZE_LOG2) + 1)
+
+struct easy_heap_tlsf_block;
+#else
+/* Define the linked list structure.  This is used to link free blocks in order
+ * of their memory address. */
+typedef struct easy_heap_block_link
+{
+    struct easy_heap_block_link *pxNextFreeBlock; /*<< The next free block in the list. */
+    easy_heap_size_t xBlockSize;                  /*<< The size of the free block. */
+} easy_heap_block_link_t;
+#endif
+
+/**
+ * @brief  Block search policies of the first-fit heap, the TLSF heap always
+ *         takes a good fit from its segregated lists.
+ */
+typedef enum easy_heap_policy
+{
+    EASY_HEAP_POLICY_FIRST_FIT = 0, ///< The lowest addressed block which fits.
+    EASY_HEAP_POLICY_NEXT_FIT = 1,  ///< The first block which fits after the last allocation, wraps around.
+    EASY_HEAP_POLICY_BEST_FIT = 2,  ///< The smallest block which fits.
+} easy_heap_policy_t;
+
+/* Number of log2 buckets of the heap histograms, the last bucket also counts
+ * every larger value. */
+#define EASY_HEAP_STATS_BUCKET_COUNT 16
+
+/**
+ * @brief   Heap instance, every instance manages its own memory region.
+ * @details The heap functions are not thread safe, the caller must protect
+ *   the instance if it is shared between threads or interrupts.
+ */
+typedef struct easy_heap
+{
+#if EASY_CONFIG_HEAP_TLSF
+    easy_heap_size_t xFlBitmap;                                                                      /*<< Non-empty first level ranges. */
+    uint32_t xSlBitmap[EASY_HEAP_TLSF_FL_INDEX_COUNT];                                               /*<< Non-empty second level lists. */
+    struct easy_heap_tlsf_block *pxBlocks[EASY_HEAP_TLSF_FL_INDEX_COUNT][EASY_HEAP_TLSF_SL_INDEX_COUNT]; /*<< Free list heads. */
+#else
+    easy_heap_block_link_t xStart;   /*<< Marks the start of the free blocks list. */
+    easy_heap_block_link_t *pxEnd;   /*<< Marks the end of the free blocks list. */
+    easy_heap_block_link_t *pxRover; /*<< Next-fit starts after this free list node. */
+    easy_heap_policy_t xPolicy;      /*<< Block search policy. */
+#if EASY_CONFIG_HEAP_WALK_LIMIT
+    uint8_t *pucBumpNext;                   /*<< Start of the bump region not carved yet, it ends at pxEnd. */
+    easy_heap_block_link_t *pxLastFreeBlock; /*<< Last node of the free list, xStart if it is empty. */
+#endif
+#endif
+
+    uintptr_t xHeapAddress;
+    easy_heap_size_t xHeapSize;
+    easy_heap_size_t xHeapFreeBytesTotal;
+
+    easy_heap_size_t xFreeBytesRemaining;
+    easy_heap_size_t xMinimumEverFreeBytesRemaining;
+    uint32_t xNumberOfSuccessfulAllocations;
+    uint32_t xNumberOfSuccessfulFrees;
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    void *pvPendingFree; /*<< Blocks freed by easy_heap_instance_free_deferred, not collected yet. */
+#endif
+
+#if EASY_CONFIG_HEAP_STATS
+    uint32_t xAllocSizeHistogram[EASY_HEAP_STATS_BUCKET_COUNT];  /*<< Requested sizes of the successful allocations. */
+    uint32_t xMallocWalkHistogram[EASY_HEAP_STATS_BUCKET_COUNT]; /*<< Free list nodes visited per malloc. */
+    uint32_t xFreeWalkHistogram[EASY_HEAP_STATS_BUCKET_COUNT];   /*<< Free list nodes visited per free. */
+#endif
+} easy_heap_t;
+
+/**
+ * @brief   Heap statistics, see easy_heap_instance_get_stats.
+ * @details The sizes of the blocks are the bytes usable by the application,
+ *   block headers are not included. xFragmentation is in per mille, 0 means
+ *   all the free memory is one block. Bucket i of the histograms counts the
+ *   values in [2^i, 2^(i+1)), bucket 0 also counts 0. The histograms are only
+ *   filled with EASY_CONFIG_HEAP_STATS enabled.
+ */
+typedef struct easy_heap_stats
+{
+    easy_heap_size_t xAvailableHeapSpaceInBytes;
+    easy_heap_size_t xSizeOfLargestFreeBlockInBytes;
+    easy_heap_size_t xSizeOfSmallestFreeBlockInBytes;
+    uint32_t xNumberOfFreeBlocks;
+    uint32_t xNumberOfUsedBlocks;
+    uint32_t xFragmentation;
+    easy_heap_size_t xMinimumEverFreeBytesRemaining;
+    uint32_t xNumberOfSuccessfulAllocations;
+    uint32_t xNumberOfSuccessfulFrees;
+    uint32_t xAllocSizeHistogram[EASY_HEAP_STATS_BUCKET_COUNT];
+    uint32_t xMallocWalkHistogram[EASY_HEAP_STATS_BUCKET_COUNT];
+    uint32_t xFreeWalkHistogram[EASY_HEAP_STATS_BUCKET_COUNT];
+} easy_heap_stats_t;
+
+/**
+ * @brief  Heap walk callback, called once for every block in address order.
+ * @param  [in] pvBlock: The start of the block payload.
+ * @param  [in] xSize: The bytes usable in the block.
+ * @param  [in] xUsed: 1 if the block is allocated, 0 if it is free.
+ * @param  [in] pvArg: The argument given to easy_heap_instance_walk.
+ * @return 0 to continue, others to stop the walk.
+ */
+typedef int (*easy_heap_walk_cb_t)(void *pvBlock, easy_heap_size_t xSize, int xUsed, void *pvArg);
+
+/**
+ * @brief  Returns the histogram bucket of a value.
+ */
+static inline int easy_heap_stats_bucket(easy_heap_size_t xValue)
+{
+    int xBucket = 0;
+
+    while (xValue > 1 && xBucket < EASY_HEAP_STATS_BUCKET_COUNT - 1)
+    {
+        xValue >>= 1;
+        xBucket++;
+    }
+
+    return xBucket;
+}
 
 /** Exported functions -------------------------------------------------------*/
-void *easy_heap_malloc(uint32_t xWantedSize);
+void *easy_heap_malloc(easy_heap_size_t xWantedSize);
 void easy_heap_free(void *pv);
-void easy_heap_init(uint32_t *heap, uint32_t size);
+void easy_heap_init(uint32_t *heap, easy_heap_size_t size);
 
-uint32_t easy_heap_get_remain_size(void);
+easy_heap_size_t easy_heap_get_remain_size(void);
 int easy_heap_check_empty(void);
 
+/**
+ * @brief  Resize a block, it grows or shrinks in place if the next physical
+ *         block is free, otherwise the data is moved to a new block.
+ * @param  [in] pv: The block to be resized, NULL works as easy_heap_malloc.
+ * @param  [in] xWantedSize: The new size, 0 frees the block.
+ * @return The resized block, NULL if failed and the old block is untouched.
+ */
+void *easy_heap_realloc(void *pv, easy_heap_size_t xWantedSize);
+
+/**
+ * @brief  Allocate zeroed memory for an array of xNum elements.
+ * @return The allocated memory, NULL if failed or xNum * xSize overflows.
+ */
+void *easy_heap_calloc(easy_heap_size_t xNum, easy_heap_size_t xSize);
+
+/**
+ * @brief  Allocate memory whose address is a multiple of xAlignment, the
+ *         block is freed by easy_heap_free as usual.
+ * @param  [in] xAlignment: The alignment, must be a power of two.
+ * @param  [in] xWantedSize: The wanted size in bytes.
+ * @return The allocated memory, NULL if failed.
+ */
+void *easy_heap_aligned_alloc(easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize);
+
+/**
+ * @brief  Returns the bytes usable in an allocated block, at least the size
+ *         asked for. Works for blocks of any heap instance.
+ */
+easy_heap_size_t easy_heap_get_usable_size(void *pv);
+
+/**
+ * @brief  Get the statistics of the default heap instance. With
+ *         EASY_CONFIG_HEAP_THREAD_CACHE only the shared instance is reported.
+ */
+void easy_heap_get_stats(easy_heap_stats_t *pxStats);
+
+/**
+ * @brief  Set the block search policy of the default heap instance (and of the
+ *         per-thread caches).
+ */
+void easy_heap_set_policy(easy_heap_policy_t xPolicy);
+
+/**
+ * @brief  Returns the default heap instance used by easy_heap_malloc.
+ */
+easy_heap_t *easy_heap_get_default(void);
+
+void *easy_heap_instance_malloc(easy_heap_t *pxHeap, easy_heap_size_t xWantedSize);
+void easy_heap_instance_free(easy_heap_t *pxHeap, void *pv);
+void easy_heap_instance_init(easy_heap_t *pxHeap, void *heap, easy_heap_size_t size);
+
+void *easy_heap_instance_realloc(easy_heap_t *pxHeap, void *pv, easy_heap_size_t xWantedSize);
+void *easy_heap_instance_calloc(easy_heap_t *pxHeap, easy_heap_size_t xNum, easy_heap_size_t xSize);
+void *easy_heap_instance_aligned_alloc(easy_heap_t *pxHeap, easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize);
+
+/**
+ * @brief  Set the block search policy of the heap instance, the default is
+ *         EASY_CONFIG_HEAP_POLICY. Ignored by the TLSF heap.
+ */
+void easy_heap_instance_set_policy(easy_heap_t *pxHeap, easy_heap_policy_t xPolicy);
+
+easy_heap_size_t easy_heap_instance_get_remain_size(easy_heap_t *pxHeap);
+int easy_heap_instance_check_empty(easy_heap_t *pxHeap);
+
+/**
+ * @brief  Get the statistics of a heap instance, the blocks are walked so it
+ *         takes time in proportion to the number of blocks.
+ */
+void easy_heap_instance_get_stats(easy_heap_t *pxHeap, easy_heap_stats_t *pxStats);
+
+/**
+ * @brief  Call pxCallback for every block of the heap instance in address
+ *         order. The heap must not be changed during the walk.
+ */
+void easy_heap_instance_walk(easy_heap_t *pxHeap, easy_heap_walk_cb_t pxCallback, void *pvArg);
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+/**
+ * @brief  Push the block to the pending list of the heap instance, it is
+ *         lock-free and O(1). The block is given back by the next malloc of
+ *         the instance or by easy_heap_instance_collect, until then it still
+ *         counts as used. A block that is pending or not allocated is ignored,
+ *         so a double free does not corrupt the pending list.
+ */
+void easy_heap_instance_free_deferred(easy_heap_t *pxHeap, void *pv);
+
+/**
+ * @brief  Give the pending blocks back to the heap instance in one batch,
+ *         the first-fit heap sorts them by address and merges them in one
+ *         walk of the free list.
+ */
+void easy_heap_instance_collect(easy_heap_t *pxHeap);
+
+/**
+ * @brief  Collect the pending blocks of the default heap, easy_heap_free
+ *         only pushes the blocks to the pending list in this mode.
+ */
+void easy_heap_collect(void);
+#endif
+
+/**
+ * @brief  Allocator hook adapters, ctx is the heap instance, NULL is the
+ *         default heap.
+ */
+void *easy_heap_hook_alloc(void *ctx, uint32_t size);
+void easy_heap_hook_free(void *ctx, void *ptr, uint32_t size);
+
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+/**
+ * @brief  Flush the frees other threads pushed to the cache of the calling
+ *         thread, and give the cache back so another thread can adopt it.
+ *         It is called automatically when a thread exits.
+ */
+void easy_heap_thread_cache_release(void);
+#endif
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*!< _EASY_HEAP_H_ */
@@ -0,0 +1,607 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_api.h"
+#include "easy_heap.h"
+#include "easy_log.h"
+#include "easy_tools_common.h"
+
+#if EASY_CONFIG_FUNCTION_HEAP
+
+/* The heap used by easy_heap_malloc and easy_heap_free. */
+static easy_heap_t xDefaultHeap;
+
+/* The memory given to easy_heap_init. */
+static uint32_t *pxHeapMemory;
+static easy_heap_size_t xHeapMemorySize;
+
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+#include <pthread.h>
+
+struct easy_heap_thread_cache
+{
+    easy_heap_t xHeap;   /*<< Only touched by the owner thread. */
+    void *pvPendingFree; /*<< Blocks freed by other threads, linked through their first word. */
+    int xOwned;          /*<< Set while a live thread owns this cache. */
+};
+
+static struct easy_heap_thread_cache xThreadCache[EASY_CONFIG_HEAP_THREAD_CACHE_MAX];
+static uint32_t xThreadCacheCount;
+static uintptr_t xThreadCacheAddress;
+static easy_heap_size_t xThreadCacheSize;
+
+static pthread_mutex_t xDefaultHeapLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t xThreadCacheKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t xThreadCacheKey;
+
+static __thread struct easy_heap_thread_cache *pxThreadCache;
+static __thread int xThreadCacheUnavailable;
+
+/*
+ * Release the blocks other threads freed to this cache, only the owner thread
+ * may call it.
+ */
+static void prvThreadCacheDrain(struct easy_heap_thread_cache *pxCache)
+{
+    void *pv = EASY_ATOMIC_EXCHANGE(&pxCache->pvPendingFree, NULL, EASY_ATOMIC_ACQUIRE);
+
+    while (pv != NULL)
+    {
+        void *pvNext = *(void **)pv;
+        easy_heap_instance_free(&pxCache->xHeap, pv);
+        pv = pvNext;
+    }
+}
+
+/*
+ * Release the blocks pushed to the cache of the calling thread, or to a cache
+ * no thread owns. Taking xOwned makes the caller the owner for the time of the
+ * drain, the pending list is checked again once it is given back, as a free
+ * may land after the drain. A thread adopting the cache meanwhile drains it at
+ * its next malloc.
+ */
+static void prvThreadCacheCollect(struct easy_heap_thread_cache *pxCache)
+{
+    int xExpected = 0;
+
+    if (pxCache == pxThreadCache)
+    {
+        prvThreadCacheDrain(pxCache);
+        return;
+    }
+
+    while (EASY_ATOMIC_LOAD(&pxCache->pvPendingFree, EASY_ATOMIC_SEQ_CST) != NULL &&
+           EASY_ATOMIC_LOAD(&pxCache->xOwned, EASY_ATOMIC_SEQ_CST) == 0 &&
+           EASY_ATOMIC_CAS(&pxCache->xOwned, &xExpected, 1, EASY_ATOMIC_ACQUIRE))
+    {
+        prvThreadCacheDrain(pxCache);
+        EASY_ATOMIC_STORE(&pxCache->xOwned, 0, EASY_ATOMIC_SEQ_CST);
+        xExpected = 0;
+    }
+}
+
+static void prvThreadCacheExit(void *pvCache)
+{
+    EASY_UNUSED(pvCache);
+    easy_heap_thread_cache_release();
+}
+
+static void prvThreadCacheKeyCreate(void)
+{
+    pthread_key_create(&xThreadCacheKey, prvThreadCacheExit);
+}
+
+/*
+ * Returns the cache of the calling thread, the first call of a thread adopts a
+ * free cache. A cache left by an exited thread is adopted with its blocks.
+ */
+static struct easy_heap_thread_cache *prvThreadCacheGet(void)
+{
+    if (pxThreadCache != NULL || xThreadCacheUnavailable)
+    {
+        return pxThreadCache;
+    }
+
+    for (uint32_t i = 0; i < xThreadCacheCount; i++)
+    {
+        int xExpected = 0;
+        if (EASY_ATOMIC_LOAD(&xThreadCache[i].xOwned, EASY_ATOMIC_RELAXED) == 0 &&
+            EASY_ATOMIC_CAS(&xThreadCache[i].xOwned, &xExpected, 1, EASY_ATOMIC_ACQUIRE))
+        {
+            pxThreadCache = &xThreadCache[i];
+            pthread_once(&xThreadCacheKeyOnce, prvThreadCacheKeyCreate);
+            pthread_setspecific(xThreadCacheKey, pxThreadCache);
+            return pxThreadCache;
+        }
+    }
+
+    /* All caches are in use, this thread uses the shared heap. */
+    xThreadCacheUnavailable = 1;
+    return NULL;
+}
+
+/*
+ * The caches are laid out back to back, so the owner is found by address.
+ */
+static struct easy_heap_thread_cache *prvThreadCacheOwner(void *pv)
+{
+    uintptr_t uxOffset = (uintptr_t)pv - xThreadCacheAddress;
+
+    if ((uintptr_t)pv < xThreadCacheAddress || uxOffset >= (uintptr_t)xThreadCacheSize * xThreadCacheCount)
+    {
+        return NULL;
+    }
+
+    return &xThreadCache[uxOffset / xThreadCacheSize];
+}
+
+void easy_heap_thread_cache_release(void)
+{
+    struct easy_heap_thread_cache *pxCache = pxThreadCache;
+
+    xThreadCacheUnavailable = 0;
+    if (pxCache == NULL)
+    {
+        return;
+    }
+
+    pxThreadCache = NULL;
+    prvThreadCacheDrain(pxCache);
+    EASY_ATOMIC_STORE(&pxCache->xOwned, 0, EASY_ATOMIC_SEQ_CST);
+
+    /* Frees pushed between the drain and the store. */
+    prvThreadCacheCollect(pxCache);
+}
+
+/*
+ * Allocate from the cache of the calling thread, then from the shared heap.
+ */
+static void *prvThreadCacheMalloc(easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize)
+{
+    struct easy_heap_thread_cache *pxCache = prvThreadCacheGet();
+    void *pv;
+
+    /* Deferred frees link the blocks through the first word. */
+    if (xWantedSize < sizeof(void *))
+    {
+        xWantedSize = sizeof(void *);
+    }
+
+    if (pxCache != NULL)
+    {
+        if (EASY_ATOMIC_LOAD(&pxCache->pvPendingFree, EASY_ATOMIC_RELAXED) != NULL)
+        {
+            prvThreadCacheDrain(pxCache);
+        }
+
+        pv = easy_heap_instance_aligned_alloc(&pxCache->xHeap, xAlignment, xWantedSize);
+        if (pv != NULL)
+        {
+            return pv;
+        }
+    }
+
+    pthread_mutex_lock(&xDefaultHeapLock);
+    pv = easy_heap_instance_aligned_alloc(&xDefaultHeap, xAlignment, xWantedSize);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+
+    return pv;
+}
+
+void *easy_heap_malloc(easy_heap_size_t xWantedSize)
+{
+    return prvThreadCacheMalloc(1, xWantedSize);
+}
+
+void *easy_heap_aligned_alloc(easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize)
+{
+    return prvThreadCacheMalloc(xAlignment, xWantedSize);
+}
+
+void *easy_heap_realloc(void *pv, easy_heap_size_t xWantedSize)
+{
+    struct easy_heap_thread_cache *pxCache;
+    void *pvReturn;
+
+    if (pv == NULL)
+    {
+        return easy_heap_malloc(xWantedSize);
+    }
+
+    if (xWantedSize == 0)
+    {
+        easy_heap_free(pv);
+        return NULL;
+    }
+
+    if (xWantedSize < sizeof(void *))
+    {
+        xWantedSize = sizeof(void *);
+    }
+
+    /* Only the owner may resize a block in place. */
+    pxCache = prvThreadCacheOwner(pv);
+    if (pxCache == NULL)
+    {
+        pthread_mutex_lock(&xDefaultHeapLock);
+        pvReturn = easy_heap_instance_realloc(&xDefaultHeap, pv, xWantedSize);
+        pthread_mutex_unlock(&xDefaultHeapLock);
+        return pvReturn;
+    }
+
+    if (pxCache == pxThreadCache)
+    {
+        pvReturn = easy_heap_instance_realloc(&pxCache->xHeap, pv, xWantedSize);
+        if (pvReturn != NULL)
+        {
+            return pvReturn;
+        }
+    }
+
+    pvReturn = easy_heap_malloc(xWantedSize);
+    if (pvReturn != NULL)
+    {
+        memcpy(pvReturn, pv, EASY_MIN(easy_heap_get_usable_size(pv), xWantedSize));
+        easy_heap_free(pv);
+    }
+
+    return pvReturn;
+}
+
+void easy_heap_free(void *pv)
+{
+    struct easy_heap_thread_cache *pxCache;
+    void *pvHead;
+
+    if (pv == NULL)
+    {
+        return;
+    }
+
+    pxCache = prvThreadCacheOwner(pv);
+    if (pxCache == NULL)
+    {
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+        /* No lock, the next malloc of the shared heap collects it. */
+        easy_heap_instance_free_deferred(&xDefaultHeap, pv);
+#else
+        pthread_mutex_lock(&xDefaultHeapLock);
+        easy_heap_instance_free(&xDefaultHeap, pv);
+        pthread_mutex_unlock(&xDefaultHeapLock);
+#endif
+        return;
+    }
+
+    if (pxCache == pxThreadCache)
+    {
+        easy_heap_instance_free(&pxCache->xHeap, pv);
+        return;
+    }
+
+    /* Owned by another thread, push it to the owner's pending list. */
+    pvHead = EASY_ATOMIC_LOAD(&pxCache->pvPendingFree, EASY_ATOMIC_RELAXED);
+    do
+    {
+        *(void **)pv = pvHead;
+    } while (!EASY_ATOMIC_CAS(&pxCache->pvPendingFree, &pvHead, pv, EASY_ATOMIC_SEQ_CST));
+
+    /* Nobody would drain it if the owner is gone. */
+    prvThreadCacheCollect(pxCache);
+}
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+void easy_heap_collect(void)
+{
+    if (pxThreadCache != NULL)
+    {
+        prvThreadCacheDrain(pxThreadCache);
+    }
+
+    pthread_mutex_lock(&xDefaultHeapLock);
+    easy_heap_instance_collect(&xDefaultHeap);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+}
+#endif
+
+void easy_heap_get_stats(easy_heap_stats_t *pxStats)
+{
+    pthread_mutex_lock(&xDefaultHeapLock);
+    easy_heap_instance_get_stats(&xDefaultHeap, pxStats);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+}
+
+easy_heap_size_t easy_heap_get_remain_size(void)
+{
+    easy_heap_size_t xRemain;
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    pthread_mutex_lock(&xDefaultHeapLock);
+    easy_heap_instance_collect(&xDefaultHeap);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+#endif
+
+    xRemain = easy_heap_instance_get_remain_size(&xDefaultHeap);
+
+    for (uint32_t i = 0; i < xThreadCacheCount; i++)
+    {
+        prvThreadCacheCollect(&xThreadCache[i]);
+        xRemain += easy_heap_instance_get_remain_size(&xThreadCache[i].xHeap);
+    }
+
+    return xRemain;
+}
+
+int easy_heap_check_empty(void)
+{
+    for (uint32_t i = 0; i < xThreadCacheCount; i++)
+    {
+        prvThreadCacheCollect(&xThreadCache[i]);
+        if (EASY_ATOMIC_LOAD(&xThreadCache[i].pvPendingFree, EASY_ATOMIC_ACQUIRE) != NULL ||
+            !easy_heap_instance_check_empty(&xThreadCache[i].xHeap))
+        {
+            return 0;
+        }
+    }
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    pthread_mutex_lock(&xDefaultHeapLock);
+    easy_heap_instance_collect(&xDefaultHeap);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+#endif
+
+    return easy_heap_instance_check_empty(&xDefaultHeap);
+}
+
+void easy_heap_init(uint32_t *heap, easy_heap_size_t size)
+{
+    uintptr_t uxAddress = ((uintptr_t)heap + sizeof(void *) - 1) & ~(uintptr_t)(sizeof(void *) - 1);
+    easy_heap_size_t xCacheSize = EASY_CONFIG_HEAP_THREAD_CACHE_SIZE & ~(easy_heap_size_t)(sizeof(void *) - 1);
+    uint32_t xCount = EASY_CONFIG_HEAP_THREAD_CACHE_MAX;
+
+    pxHeapMemory = heap;
+    xHeapMemorySize = size;
+
+    if (heap == NULL || size < (easy_heap_size_t)(uxAddress - (uintptr_t)heap))
+    {
+        xCount = 0;
+    }
+    else
+    {
+        size -= (easy_heap_size_t)(uxAddress - (uintptr_t)heap);
+    }
+
+    /* The caches take at most half of the heap memory. */
+    while (xCount > 0 && (uint64_t)xCacheSize * xCount > size / 2)
+    {
+        xCount--;
+    }
+
+    if (heap != NULL && xCount == 0)
+    {
+        EASY_LOG_WRN("heap of %lu bytes has no room for a %lu bytes thread cache, all threads share the heap\n", (unsigned long)xHeapMemorySize,
+                     (unsigned long)xCacheSize);
+    }
+
+    xThreadCacheAddress = uxAddress;
+    xThreadCacheSize = xCacheSize;
+    xThreadCacheCount = xCount;
+    for (uint32_t i = 0; i < xCount; i++)
+    {
+        easy_heap_instance_init(&xThreadCache[i].xHeap, (void *)(uxAddress + (uintptr_t)xCacheSize * i), xCacheSize);
+        xThreadCache[i].pvPendingFree = NULL;
+        xThreadCache[i].xOwned = 0;
+    }
+
+    if (heap == NULL)
+    {
+        easy_heap_instance_init(&xDefaultHeap, NULL, 0);
+    }
+    else
+    {
+        easy_heap_instance_init(&xDefaultHeap, (void *)(uxAddress + (uintptr_t)xCacheSize * xCount), size - xCacheSize * xCount);
+    }
+}
+#else
+void *easy_heap_malloc(easy_heap_size_t xWantedSize)
+{
+    return easy_heap_instance_malloc(&xDefaultHeap, xWantedSize);
+}
+
+void easy_heap_free(void *pv)
+{
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    easy_heap_instance_free_deferred(&xDefaultHeap, pv);
+#else
+    easy_heap_instance_free(&xDefaultHeap, pv);
+#endif
+}
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+void easy_heap_collect(void)
+{
+    easy_heap_instance_collect(&xDefaultHeap);
+}
+#endif
+
+void *easy_heap_realloc(void *pv, easy_heap_size_t xWantedSize)
+{
+    return easy_heap_instance_realloc(&xDefaultHeap, pv, xWantedSize);
+}
+
+void *easy_heap_aligned_alloc(easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize)
+{
+    return easy_heap_instance_aligned_alloc(&xDefaultHeap, xAlignment, xWantedSize);
+}
+
+void easy_heap_get_stats(easy_heap_stats_t *pxStats)
+{
+    easy_heap_instance_get_stats(&xDefaultHeap, pxStats);
+}
+
+easy_heap_size_t easy_heap_get_remain_size(void)
+{
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    easy_heap_instance_collect(&xDefaultHeap);
+#endif
+    return easy_heap_instance_get_remain_size(&xDefaultHeap);
+}
+
+int easy_heap_check_empty(void)
+{
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    easy_heap_instance_collect(&xDefaultHeap);
+#endif
+    return easy_heap_instance_check_empty(&xDefaultHeap);
+}
+
+void easy_heap_init(uint32_t *heap, easy_heap_size_t size)
+{
+    pxHeapMemory = heap;
+    xHeapMemorySize = size;
+
+    easy_heap_instance_init(&xDefaultHeap, heap, size);
+}
+#endif // EASY_CONFIG_HEAP_THREAD_CACHE
+
+void *easy_heap_instance_calloc(easy_heap_t *pxHeap, easy_heap_size_t xNum, easy_heap_size_t xSize)
+{
+    void *pv;
+
+    if (xSize != 0 && xNum > (easy_heap_size_t)-1 / xSize)
+    {
+        return NULL;
+    }
+
+    pv = easy_heap_instance_malloc(pxHeap, xNum * xSize);
+    if (pv != NULL)
+    {
+        memset(pv, 0, xNum * xSize);
+    }
+
+    return pv;
+}
+
+void *easy_heap_calloc(easy_heap_size_t xNum, easy_heap_size_t xSize)
+{
+    void *pv;
+
+    if (xSize != 0 && xNum > (easy_heap_size_t)-1 / xSize)
+    {
+        return NULL;
+    }
+
+    pv = easy_heap_malloc(xNum * xSize);
+    if (pv != NULL)
+    {
+        memset(pv, 0, xNum * xSize);
+    }
+
+    return pv;
+}
+
+static int prvStatsWalk(void *pvBlock, easy_heap_size_t xSize, int xUsed, void *pvArg)
+{
+    easy_heap_stats_t *pxStats = pvArg;
+
+    EASY_UNUSED(pvBlock);
+
+    if (xUsed)
+    {
+        pxStats->xNumberOfUsedBlocks++;
+        return 0;
+    }
+
+    pxStats->xNumberOfFreeBlocks++;
+    pxStats->xAvailableHeapSpaceInBytes += xSize;
+    if (xSize > pxStats->xSizeOfLargestFreeBlockInBytes)
+    {
+        pxStats->xSizeOfLargestFreeBlockInBytes = xSize;
+    }
+    if (pxStats->xNumberOfFreeBlocks == 1 || xSize < pxStats->xSizeOfSmallestFreeBlockInBytes)
+    {
+        pxStats->xSizeOfSmallestFreeBlockInBytes = xSize;
+    }
+
+    return 0;
+}
+
+void easy_heap_instance_get_stats(easy_heap_t *pxHeap, easy_heap_stats_t *pxStats)
+{
+    memset(pxStats, 0, sizeof(*pxStats));
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    /* Pending blocks would show up as used. */
+    easy_heap_instance_collect(pxHeap);
+#endif
+
+    easy_heap_instance_walk(pxHeap, prvStatsWalk, pxStats);
+
+    /* The share of the free space which is not in the largest block. */
+    if (pxStats->xAvailableHeapSpaceInBytes != 0)
+    {
+        pxStats->xFragmentation = 1000 - (uint32_t)((uint64_t)pxStats->xSizeOfLargestFreeBlockInBytes * 1000 / pxStats->xAvailableHeapSpaceInBytes);
+    }
+
+    pxStats->xMinimumEverFreeBytesRemaining = pxHeap->xMinimumEverFreeBytesRemaining;
+    pxStats->xNumberOfSuccessfulAllocations = pxHeap->xNumberOfSuccessfulAllocations;
+    pxStats->xNumberOfSuccessfulFrees = pxHeap->xNumberOfSuccessfulFrees;
+#if EASY_CONFIG_HEAP_STATS
+    memcpy(pxStats->xAllocSizeHistogram, pxHeap->xAllocSizeHistogram, sizeof(pxStats->xAllocSizeHistogram));
+    memcpy(pxStats->xMallocWalkHistogram, pxHeap->xMallocWalkHistogram, sizeof(pxStats->xMallocWalkHistogram));
+    memcpy(pxStats->xFreeWalkHistogram, pxHeap->xFreeWalkHistogram, sizeof(pxStats->xFreeWalkHistogram));
+#endif
+}
+
+void easy_heap_set_policy(easy_heap_policy_t xPolicy)
+{
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+    pthread_mutex_lock(&xDefaultHeapLock);
+    easy_heap_instance_set_policy(&xDefaultHeap, xPolicy);
+    pthread_mutex_unlock(&xDefaultHeapLock);
+
+    /* A cache is only touched by its owner, so this must be called before
+     * other threads use the heap. */
+    for (uint32_t i = 0; i < xThreadCacheCount; i++)
+    {
+        easy_heap_instance_set_policy(&xThreadCache[i].xHeap, xPolicy);
+    }
+#else
+    easy_heap_instance_set_policy(&xDefaultHeap, xPolicy);
+#endif
+}
+
+easy_heap_t *easy_heap_get_default(void)
+{
+    return &xDefaultHeap;
+}
+
+void *easy_heap_hook_alloc(void *ctx, uint32_t size)
+{
+    if (ctx == NULL)
+    {
+        return easy_heap_malloc(size);
+    }
+
+    return easy_heap_instance_malloc((easy_heap_t *)ctx, size);
+}
+
+void easy_heap_hook_free(void *ctx, void *ptr, uint32_t size)
+{
+    EASY_UNUSED(size);
+
+    if (ctx == NULL)
+    {
+        easy_heap_free(ptr);
+    }
+    else
+    {
+        easy_heap_instance_free((easy_heap_t *)ctx, ptr);
+    }
+}
+
+void easy_heap_reinit(void)
+{
+    easy_heap_init(pxHeapMemory, xHeapMemorySize);
+}
+#endif // EASY_CONFIG_FUNCTION_HEAP
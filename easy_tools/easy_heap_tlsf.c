@@ -0,0 +1,709 @@
+#include "easy_heap.h"
+#include "easy_tools_common.h"
+#include "easy_tools_config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if EASY_CONFIG_FUNCTION_HEAP && EASY_CONFIG_HEAP_TLSF
+
+/*
+ * Two-Level Segregated Fit allocator.
+ *
+ * Free blocks are kept in (FL x SL) segregated lists. The first level splits
+ * sizes by power of two, the second level splits each power of two range into
+ * (1 << EASY_CONFIG_HEAP_TLSF_SL_LOG2) linear lists. Two bitmaps record which
+ * lists are non-empty, so a suitable list is found with two find-first-set
+ * instructions. Every block keeps a pointer to its previous physical block, so
+ * coalescing on free is O(1) as well.
+ */
+
+#define TLSF_SL_INDEX_COUNT_LOG2 EASY_CONFIG_HEAP_TLSF_SL_LOG2
+#define TLSF_SL_INDEX_COUNT      EASY_HEAP_TLSF_SL_INDEX_COUNT
+
+#define TLSF_ALIGN_SIZE_LOG2 EASY_HEAP_TLSF_ALIGN_SIZE_LOG2
+#define TLSF_ALIGN_SIZE      (1 << TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_ALIGN_MASK      (TLSF_ALIGN_SIZE - 1)
+
+/* Sizes below TLSF_SMALL_BLOCK_SIZE are all mapped to first level 0. */
+#define TLSF_FL_INDEX_MAX   EASY_CONFIG_HEAP_TLSF_FL_MAX
+#define TLSF_FL_INDEX_SHIFT (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_FL_INDEX_COUNT EASY_HEAP_TLSF_FL_INDEX_COUNT
+#define TLSF_SMALL_BLOCK_SIZE (1 << TLSF_FL_INDEX_SHIFT)
+
+#define TLSF_BLOCK_FREE      0x1 /*<< This block is free. */
+#define TLSF_BLOCK_PREV_FREE 0x2 /*<< The previous physical block is free. */
+#define TLSF_BLOCK_PENDING   0x4 /*<< This block waits in the deferred free list. */
+#define TLSF_BLOCK_FLAGS     (TLSF_BLOCK_FREE | TLSF_BLOCK_PREV_FREE | TLSF_BLOCK_PENDING)
+
+/* TLSF_BLOCK_PENDING is set from any thread, the flags the heap updates on a
+ * used block (TLSF_BLOCK_PREV_FREE of the next one) then need atomic ops. */
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+#define TLSF_FLAG_SET(pxBlock, xFlag)   ((void)EASY_ATOMIC_FETCH_OR(&(pxBlock)->xBlockSize, (easy_heap_size_t)(xFlag), EASY_ATOMIC_RELAXED))
+#define TLSF_FLAG_CLEAR(pxBlock, xFlag) ((void)EASY_ATOMIC_FETCH_AND(&(pxBlock)->xBlockSize, ~(easy_heap_size_t)(xFlag), EASY_ATOMIC_RELAXED))
+#else
+#define TLSF_FLAG_SET(pxBlock, xFlag)   ((pxBlock)->xBlockSize |= (xFlag))
+#define TLSF_FLAG_CLEAR(pxBlock, xFlag) ((pxBlock)->xBlockSize &= ~(easy_heap_size_t)(xFlag))
+#endif
+
+/* Block header, pxNextFree and pxPrevFree are only valid for free blocks and
+ * overlap the user payload of allocated blocks. */
+typedef struct easy_heap_tlsf_block
+{
+    struct easy_heap_tlsf_block *pxPrevPhysBlock; /*<< The previous physical block, only valid if it is free. */
+    easy_heap_size_t xBlockSize;                  /*<< The size of the block (header included), low bits are flags. */
+    struct easy_heap_tlsf_block *pxNextFree;      /*<< The next block in the same free list. */
+    struct easy_heap_tlsf_block *pxPrevFree;      /*<< The previous block in the same free list. */
+} TlsfBlock_t;
+
+#define TLSF_BLOCK_OVERHEAD  ((offsetof(TlsfBlock_t, pxNextFree) + TLSF_ALIGN_MASK) & ~TLSF_ALIGN_MASK)
+#define TLSF_BLOCK_SIZE_MIN  ((sizeof(TlsfBlock_t) + TLSF_ALIGN_MASK) & ~TLSF_ALIGN_MASK)
+#define TLSF_BLOCK_SIZE_MAX  ((easy_heap_size_t)1 << TLSF_FL_INDEX_MAX)
+
+#if EASY_CONFIG_HEAP_STATS
+#define TLSF_STATS_RECORD(pxHeap, xHistogram, xValue) ((pxHeap)->xHistogram[easy_heap_stats_bucket(xValue)]++)
+#else
+#define TLSF_STATS_RECORD(pxHeap, xHistogram, xValue) ((void)(xValue))
+#endif
+
+#if EASY_CONFIG_HEAP_SIZE_64BIT
+#if TLSF_FL_INDEX_MAX > 62
+#error "EASY_CONFIG_HEAP_TLSF_FL_MAX must be less than 63."
+#endif
+
+static inline int prvTlsfFls(easy_heap_size_t x)
+{
+    return x ? 63 - __builtin_clzll((unsigned long long)x) : -1;
+}
+
+static inline int prvTlsfFfs(easy_heap_size_t x)
+{
+    return x ? __builtin_ctzll((unsigned long long)x) : -1;
+}
+#else
+#if TLSF_FL_INDEX_MAX > 31
+#error "EASY_CONFIG_HEAP_TLSF_FL_MAX must be less than 32."
+#endif
+
+static inline int prvTlsfFls(easy_heap_size_t x)
+{
+    return x ? 31 - __builtin_clz(x) : -1;
+}
+
+static inline int prvTlsfFfs(easy_heap_size_t x)
+{
+    return x ? __builtin_ctz(x) : -1;
+}
+#endif
+
+static inline easy_heap_size_t prvBlockSize(const TlsfBlock_t *pxBlock)
+{
+    return pxBlock->xBlockSize & ~TLSF_BLOCK_FLAGS;
+}
+
+static inline TlsfBlock_t *prvBlockNext(const TlsfBlock_t *pxBlock)
+{
+    return (TlsfBlock_t *)((uint8_t *)pxBlock + prvBlockSize(pxBlock));
+}
+
+/*
+ * Map a block size to the list that holds blocks of exactly this class.
+ */
+static void prvMappingInsert(easy_heap_size_t xSize, int *pxFl, int *pxSl)
+{
+    int fl, sl;
+
+    if (xSize < TLSF_SMALL_BLOCK_SIZE)
+    {
+        fl = 0;
+        sl = (int)xSize / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT);
+    }
+    else
+    {
+        fl = prvTlsfFls(xSize);
+        sl = (int)(xSize >> (fl - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+        fl -= (TLSF_FL_INDEX_SHIFT - 1);
+    }
+
+    *pxFl = fl;
+    *pxSl = sl;
+}
+
+/*
+ * Map a requested size to the first list whose every block is large enough,
+ * so the head of that list can be taken without searching.
+ */
+static void prvMappingSearch(easy_heap_size_t xSize, int *pxFl, int *pxSl)
+{
+    if (xSize >= TLSF_SMALL_BLOCK_SIZE)
+    {
+        xSize += ((easy_heap_size_t)1 << (prvTlsfFls(xSize) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+
+    prvMappingInsert(xSize, pxFl, pxSl);
+}
+
+static TlsfBlock_t *prvSearchSuitableBlock(easy_heap_t *pxHeap, int *pxFl, int *pxSl)
+{
+    int fl = *pxFl;
+    int sl = *pxSl;
+    uint32_t xSlMap;
+    easy_heap_size_t xFlMap;
+
+    if (fl >= TLSF_FL_INDEX_COUNT)
+    {
+        return NULL;
+    }
+
+    /* Search for a non-empty list at this first level, then for the next
+     * non-empty first level above it. */
+    xSlMap = pxHeap->xSlBitmap[fl] & (~(uint32_t)0 << sl);
+    if (xSlMap == 0)
+    {
+        xFlMap = (fl + 1 < (int)(sizeof(easy_heap_size_t) * 8)) ? (pxHeap->xFlBitmap & (~(easy_heap_size_t)0 << (fl + 1))) : 0;
+        if (xFlMap == 0)
+        {
+            return NULL;
+        }
+
+        fl = prvTlsfFfs(xFlMap);
+        xSlMap = pxHeap->xSlBitmap[fl];
+    }
+    sl = prvTlsfFfs(xSlMap);
+
+    *pxFl = fl;
+    *pxSl = sl;
+
+    return pxHeap->pxBlocks[fl][sl];
+}
+
+static void prvRemoveFreeBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock, int fl, int sl)
+{
+    TlsfBlock_t *pxPrev = pxBlock->pxPrevFree;
+    TlsfBlock_t *pxNext = pxBlock->pxNextFree;
+
+    if (pxNext != NULL)
+    {
+        pxNext->pxPrevFree = pxPrev;
+    }
+    if (pxPrev != NULL)
+    {
+        pxPrev->pxNextFree = pxNext;
+    }
+
+    /* If this block is the head of the list, set new head. */
+    if (pxHeap->pxBlocks[fl][sl] == pxBlock)
+    {
+        pxHeap->pxBlocks[fl][sl] = pxNext;
+
+        /* If the new head is null, clear the bitmaps. */
+        if (pxNext == NULL)
+        {
+            pxHeap->xSlBitmap[fl] &= ~((uint32_t)1 << sl);
+            if (pxHeap->xSlBitmap[fl] == 0)
+            {
+                pxHeap->xFlBitmap &= ~((easy_heap_size_t)1 << fl);
+            }
+        }
+    }
+}
+
+static void prvInsertFreeBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock)
+{
+    int fl, sl;
+
+    prvMappingInsert(prvBlockSize(pxBlock), &fl, &sl);
+
+    pxBlock->pxPrevFree = NULL;
+    pxBlock->pxNextFree = pxHeap->pxBlocks[fl][sl];
+    if (pxBlock->pxNextFree != NULL)
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock;
+    }
+    pxHeap->pxBlocks[fl][sl] = pxBlock;
+
+    pxHeap->xFlBitmap |= ((easy_heap_size_t)1 << fl);
+    pxHeap->xSlBitmap[fl] |= ((uint32_t)1 << sl);
+}
+
+static void prvUnlinkFreeBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock)
+{
+    int fl, sl;
+
+    prvMappingInsert(prvBlockSize(pxBlock), &fl, &sl);
+    prvRemoveFreeBlock(pxHeap, pxBlock, fl, sl);
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the block size needed for xWantedSize bytes of payload, 0 if it is
+ * larger than any block can be.
+ */
+static easy_heap_size_t prvBlockSizeFor(easy_heap_size_t xWantedSize)
+{
+    if (xWantedSize > TLSF_BLOCK_SIZE_MAX)
+    {
+        return 0;
+    }
+
+    xWantedSize = (xWantedSize + TLSF_BLOCK_OVERHEAD + TLSF_ALIGN_MASK) & ~TLSF_ALIGN_MASK;
+    if (xWantedSize < TLSF_BLOCK_SIZE_MIN)
+    {
+        xWantedSize = TLSF_BLOCK_SIZE_MIN;
+    }
+
+    return xWantedSize;
+}
+
+/*
+ * Merges a block already marked free with its free physical neighbours and
+ * puts the result into the free lists.
+ */
+static void prvMergeFreeBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock)
+{
+    TlsfBlock_t *pxPrev, *pxNext;
+
+    /* Merge with the previous physical block if it is free. */
+    if ((pxBlock->xBlockSize & TLSF_BLOCK_PREV_FREE) != 0)
+    {
+        pxPrev = pxBlock->pxPrevPhysBlock;
+        prvUnlinkFreeBlock(pxHeap, pxPrev);
+        pxPrev->xBlockSize += prvBlockSize(pxBlock);
+        pxBlock = pxPrev;
+    }
+
+    /* Merge with the next physical block if it is free, the end marker is
+     * never free so this stops at the end of the heap. */
+    pxNext = prvBlockNext(pxBlock);
+    if ((pxNext->xBlockSize & TLSF_BLOCK_FREE) != 0)
+    {
+        prvUnlinkFreeBlock(pxHeap, pxNext);
+        pxBlock->xBlockSize += prvBlockSize(pxNext);
+        pxNext = prvBlockNext(pxBlock);
+    }
+
+    pxBlock->xBlockSize |= TLSF_BLOCK_FREE;
+    pxNext->pxPrevPhysBlock = pxBlock;
+    TLSF_FLAG_SET(pxNext, TLSF_BLOCK_PREV_FREE);
+
+    prvInsertFreeBlock(pxHeap, pxBlock);
+}
+
+/*
+ * Gives the tail of a used block back to the free lists if it is large enough
+ * to be a block of its own.
+ */
+static void prvTrimUsedBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock, easy_heap_size_t xWantedSize)
+{
+    easy_heap_size_t xBlockSize = prvBlockSize(pxBlock);
+    TlsfBlock_t *pxRemain;
+
+    if ((xBlockSize - xWantedSize) >= TLSF_BLOCK_SIZE_MIN)
+    {
+        pxRemain = (TlsfBlock_t *)((uint8_t *)pxBlock + xWantedSize);
+        pxRemain->xBlockSize = (xBlockSize - xWantedSize) | TLSF_BLOCK_FREE;
+        pxRemain->pxPrevPhysBlock = pxBlock;
+        pxBlock->xBlockSize = xWantedSize | (pxBlock->xBlockSize & TLSF_BLOCK_PREV_FREE);
+
+        pxHeap->xFreeBytesRemaining += prvBlockSize(pxRemain);
+        prvMergeFreeBlock(pxHeap, pxRemain);
+    }
+}
+
+/*
+ * Appends the next physical block to a used block if it is free and the two
+ * of them hold at least xWantedSize bytes.  Returns 1 if merged.
+ */
+static int prvGrowUsedBlock(easy_heap_t *pxHeap, TlsfBlock_t *pxBlock, easy_heap_size_t xWantedSize)
+{
+    TlsfBlock_t *pxNext = prvBlockNext(pxBlock);
+
+    if ((pxNext->xBlockSize & TLSF_BLOCK_FREE) == 0 || (prvBlockSize(pxBlock) + prvBlockSize(pxNext)) < xWantedSize)
+    {
+        return 0;
+    }
+
+    prvUnlinkFreeBlock(pxHeap, pxNext);
+    pxHeap->xFreeBytesRemaining -= prvBlockSize(pxNext);
+    if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
+    {
+        pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
+    }
+
+    pxBlock->xBlockSize += prvBlockSize(pxNext);
+    TLSF_FLAG_CLEAR(prvBlockNext(pxBlock), TLSF_BLOCK_PREV_FREE);
+
+    return 1;
+}
+
+/*-----------------------------------------------------------*/
+
+void easy_heap_instance_set_policy(easy_heap_t *pxHeap, easy_heap_policy_t xPolicy)
+{
+    /* The segregated lists give a good fit already. */
+    (void)pxHeap;
+    (void)xPolicy;
+}
+
+void *easy_heap_instance_malloc(easy_heap_t *pxHeap, easy_heap_size_t xWantedSize)
+{
+    TlsfBlock_t *pxBlock, *pxRemain, *pxNext;
+    easy_heap_size_t xRequestedSize = xWantedSize;
+    easy_heap_size_t xBlockSize;
+    int fl, sl;
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    if (EASY_ATOMIC_LOAD(&pxHeap->pvPendingFree, EASY_ATOMIC_RELAXED) != NULL)
+    {
+        easy_heap_instance_collect(pxHeap);
+    }
+#endif
+
+    xWantedSize = prvBlockSizeFor(xWantedSize);
+    if (xWantedSize == 0 || xWantedSize > pxHeap->xFreeBytesRemaining)
+    {
+        return NULL;
+    }
+
+    prvMappingSearch(xWantedSize, &fl, &sl);
+    pxBlock = prvSearchSuitableBlock(pxHeap, &fl, &sl);
+
+    /* The head of the found list is taken, no list is walked. */
+    TLSF_STATS_RECORD(pxHeap, xMallocWalkHistogram, 1);
+    if (pxBlock == NULL)
+    {
+        return NULL;
+    }
+
+    prvRemoveFreeBlock(pxHeap, pxBlock, fl, sl);
+
+    xBlockSize = prvBlockSize(pxBlock);
+    pxNext = prvBlockNext(pxBlock);
+
+    /* If the block is larger than required it can be split into two, the
+     * remainder goes back to the free lists. */
+    if ((xBlockSize - xWantedSize) >= TLSF_BLOCK_SIZE_MIN)
+    {
+        pxRemain = (TlsfBlock_t *)((uint8_t *)pxBlock + xWantedSize);
+        pxRemain->xBlockSize = (xBlockSize - xWantedSize) | TLSF_BLOCK_FREE;
+        pxRemain->pxPrevPhysBlock = pxBlock;
+        pxNext->pxPrevPhysBlock = pxRemain;
+        prvInsertFreeBlock(pxHeap, pxRemain);
+
+        xBlockSize = xWantedSize;
+    }
+    else
+    {
+        TLSF_FLAG_CLEAR(pxNext, TLSF_BLOCK_PREV_FREE);
+    }
+
+    pxBlock->xBlockSize = xBlockSize | (pxBlock->xBlockSize & TLSF_BLOCK_PREV_FREE);
+
+    pxHeap->xFreeBytesRemaining -= xBlockSize;
+    if (pxHeap->xFreeBytesRemaining < pxHeap->xMinimumEverFreeBytesRemaining)
+    {
+        pxHeap->xMinimumEverFreeBytesRemaining = pxHeap->xFreeBytesRemaining;
+    }
+    pxHeap->xNumberOfSuccessfulAllocations++;
+    TLSF_STATS_RECORD(pxHeap, xAllocSizeHistogram, xRequestedSize);
+
+    return (uint8_t *)pxBlock + TLSF_BLOCK_OVERHEAD;
+}
+
+/*-----------------------------------------------------------*/
+
+void easy_heap_instance_free(easy_heap_t *pxHeap, void *pv)
+{
+    TlsfBlock_t *pxBlock;
+
+    if (pv == NULL)
+    {
+        return;
+    }
+
+    pxBlock = (TlsfBlock_t *)((uint8_t *)pv - TLSF_BLOCK_OVERHEAD);
+
+    /* Check the block is actually allocated and not pending. */
+    if ((pxBlock->xBlockSize & (TLSF_BLOCK_FREE | TLSF_BLOCK_PENDING)) != 0)
+    {
+        return;
+    }
+
+    pxBlock->xBlockSize |= TLSF_BLOCK_FREE;
+    pxHeap->xFreeBytesRemaining += prvBlockSize(pxBlock);
+    pxHeap->xNumberOfSuccessfulFrees++;
+    TLSF_STATS_RECORD(pxHeap, xFreeWalkHistogram, 0);
+
+    prvMergeFreeBlock(pxHeap, pxBlock);
+}
+
+/*-----------------------------------------------------------*/
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+void easy_heap_instance_free_deferred(easy_heap_t *pxHeap, void *pv)
+{
+    TlsfBlock_t *pxBlock;
+    easy_heap_size_t xBlockSize;
+    void *pvHead;
+
+    if (pv == NULL)
+    {
+        return;
+    }
+
+    /* The pending blocks are linked through pxNextFree, it is in the payload
+     * which is not used any more. TLSF_BLOCK_PENDING is set first, so a block
+     * freed twice (or a free block) is never pushed again. */
+    pxBlock = (TlsfBlock_t *)((uint8_t *)pv - TLSF_BLOCK_OVERHEAD);
+    xBlockSize = EASY_ATOMIC_LOAD(&pxBlock->xBlockSize, EASY_ATOMIC_RELAXED);
+    do
+    {
+        if ((xBlockSize & (TLSF_BLOCK_FREE | TLSF_BLOCK_PENDING)) != 0)
+        {
+            return;
+        }
+    } while (!EASY_ATOMIC_CAS(&pxBlock->xBlockSize, &xBlockSize, xBlockSize | TLSF_BLOCK_PENDING, EASY_ATOMIC_RELAXED));
+
+    pvHead = EASY_ATOMIC_LOAD(&pxHeap->pvPendingFree, EASY_ATOMIC_RELAXED);
+    do
+    {
+        pxBlock->pxNextFree = pvHead;
+    } while (!EASY_ATOMIC_CAS(&pxHeap->pvPendingFree, &pvHead, pxBlock, EASY_ATOMIC_RELEASE));
+}
+
+void easy_heap_instance_collect(easy_heap_t *pxHeap)
+{
+    TlsfBlock_t *pxBlock = EASY_ATOMIC_EXCHANGE(&pxHeap->pvPendingFree, NULL, EASY_ATOMIC_ACQUIRE);
+    TlsfBlock_t *pxNext;
+
+    /* Every free is O(1) already, the batch needs no sorting. */
+    while (pxBlock != NULL)
+    {
+        pxNext = pxBlock->pxNextFree;
+        TLSF_FLAG_CLEAR(pxBlock, TLSF_BLOCK_PENDING);
+        easy_heap_instance_free(pxHeap, (uint8_t *)pxBlock + TLSF_BLOCK_OVERHEAD);
+        pxBlock = pxNext;
+    }
+}
+#endif
+
+/*-----------------------------------------------------------*/
+
+void *easy_heap_instance_realloc(easy_heap_t *pxHeap, void *pv, easy_heap_size_t xWantedSize)
+{
+    TlsfBlock_t *pxBlock;
+    easy_heap_size_t xBlockSize;
+    void *pvReturn;
+
+    if (pv == NULL)
+    {
+        return easy_heap_instance_malloc(pxHeap, xWantedSize);
+    }
+
+    if (xWantedSize == 0)
+    {
+        easy_heap_instance_free(pxHeap, pv);
+        return NULL;
+    }
+
+    pxBlock = (TlsfBlock_t *)((uint8_t *)pv - TLSF_BLOCK_OVERHEAD);
+    xBlockSize = prvBlockSizeFor(xWantedSize);
+    if ((pxBlock->xBlockSize & (TLSF_BLOCK_FREE | TLSF_BLOCK_PENDING)) != 0 || xBlockSize == 0)
+    {
+        return NULL;
+    }
+
+    /* Shrink, or grow into the free block behind, without moving the data. */
+    if (prvBlockSize(pxBlock) >= xBlockSize || prvGrowUsedBlock(pxHeap, pxBlock, xBlockSize))
+    {
+        prvTrimUsedBlock(pxHeap, pxBlock, xBlockSize);
+        return pv;
+    }
+
+    pvReturn = easy_heap_instance_malloc(pxHeap, xWantedSize);
+    if (pvReturn != NULL)
+    {
+        memcpy(pvReturn, pv, prvBlockSize(pxBlock) - TLSF_BLOCK_OVERHEAD);
+        easy_heap_instance_free(pxHeap, pv);
+    }
+
+    return pvReturn;
+}
+
+void *easy_heap_instance_aligned_alloc(easy_heap_t *pxHeap, easy_heap_size_t xAlignment, easy_heap_size_t xWantedSize)
+{
+    TlsfBlock_t *pxBlock, *pxAlignedBlock;
+    easy_heap_size_t xBlockSize, xGap;
+    uintptr_t uxAligned;
+    uint8_t *pvReturn;
+
+    if (xAlignment == 0 || (xAlignment & (xAlignment - 1)) != 0)
+    {
+        return NULL;
+    }
+
+    if (xAlignment <= TLSF_ALIGN_SIZE)
+    {
+        return easy_heap_instance_malloc(pxHeap, xWantedSize);
+    }
+
+    /* Allocate enough to move the payload up to the boundary while leaving a
+     * valid free block in front of it. */
+    xBlockSize = prvBlockSizeFor(xWantedSize);
+    if (xBlockSize == 0 || xAlignment > TLSF_BLOCK_SIZE_MAX || xBlockSize > TLSF_BLOCK_SIZE_MAX - xAlignment - TLSF_BLOCK_SIZE_MIN)
+    {
+        return NULL;
+    }
+
+    pvReturn = easy_heap_instance_malloc(pxHeap, xBlockSize - TLSF_BLOCK_OVERHEAD + xAlignment + TLSF_BLOCK_SIZE_MIN);
+    if (pvReturn == NULL)
+    {
+        return NULL;
+    }
+
+    pxBlock = (TlsfBlock_t *)(pvReturn - TLSF_BLOCK_OVERHEAD);
+    if (((uintptr_t)pvReturn & (xAlignment - 1)) != 0)
+    {
+        uxAligned = ((uintptr_t)pvReturn + TLSF_BLOCK_SIZE_MIN + xAlignment - 1) & ~(uintptr_t)(xAlignment - 1);
+        xGap = (easy_heap_size_t)(uxAligned - (uintptr_t)pvReturn);
+
+        pxAlignedBlock = (TlsfBlock_t *)(uxAligned - TLSF_BLOCK_OVERHEAD);
+        pxAlignedBlock->xBlockSize = prvBlockSize(pxBlock) - xGap;
+        pxAlignedBlock->pxPrevPhysBlock = pxBlock;
+
+        /* The leading gap becomes a free block of its own. */
+        pxBlock->xBlockSize = xGap | TLSF_BLOCK_FREE | (pxBlock->xBlockSize & TLSF_BLOCK_PREV_FREE);
+        pxHeap->xFreeBytesRemaining += xGap;
+        prvMergeFreeBlock(pxHeap, pxBlock);
+
+        pxBlock = pxAlignedBlock;
+        pvReturn = (uint8_t *)uxAligned;
+    }
+
+    prvTrimUsedBlock(pxHeap, pxBlock, xBlockSize);
+
+    return pvReturn;
+}
+
+easy_heap_size_t easy_heap_get_usable_size(void *pv)
+{
+    TlsfBlock_t *pxBlock;
+
+    if (pv == NULL)
+    {
+        return 0;
+    }
+
+    pxBlock = (TlsfBlock_t *)((uint8_t *)pv - TLSF_BLOCK_OVERHEAD);
+    if ((pxBlock->xBlockSize & (TLSF_BLOCK_FREE | TLSF_BLOCK_PENDING)) != 0)
+    {
+        return 0;
+    }
+
+    return prvBlockSize(pxBlock) - TLSF_BLOCK_OVERHEAD;
+}
+
+void easy_heap_instance_walk(easy_heap_t *pxHeap, easy_heap_walk_cb_t pxCallback, void *pvArg)
+{
+    TlsfBlock_t *pxBlock = (TlsfBlock_t *)pxHeap->xHeapAddress;
+
+    if (pxBlock == NULL)
+    {
+        return;
+    }
+
+    /* The blocks cover the heap space back to back up to the zero sized end
+     * marker. */
+    while (prvBlockSize(pxBlock) != 0)
+    {
+        if (pxCallback((uint8_t *)pxBlock + TLSF_BLOCK_OVERHEAD, prvBlockSize(pxBlock) - TLSF_BLOCK_OVERHEAD, (pxBlock->xBlockSize & TLSF_BLOCK_FREE) == 0,
+                       pvArg) != 0)
+        {
+            break;
+        }
+        pxBlock = prvBlockNext(pxBlock);
+    }
+}
+
+easy_heap_size_t easy_heap_instance_get_remain_size(easy_heap_t *pxHeap)
+{
+    return pxHeap->xFreeBytesRemaining;
+}
+
+int easy_heap_instance_check_empty(easy_heap_t *pxHeap)
+{
+    return pxHeap->xHeapFreeBytesTotal == pxHeap->xFreeBytesRemaining;
+}
+
+void easy_heap_instance_init(easy_heap_t *pxHeap, void *heap, easy_heap_size_t size)
+{
+    TlsfBlock_t *pxFirstFreeBlock, *pxEnd;
+    uintptr_t uxAddress;
+    easy_heap_size_t xPoolSize;
+    int i, j;
+
+    pxHeap->xFlBitmap = 0;
+    for (i = 0; i < TLSF_FL_INDEX_COUNT; i++)
+    {
+        pxHeap->xSlBitmap[i] = 0;
+        for (j = 0; j < TLSF_SL_INDEX_COUNT; j++)
+        {
+            pxHeap->pxBlocks[i][j] = NULL;
+        }
+    }
+
+    pxHeap->xHeapAddress = 0;
+    pxHeap->xHeapSize = 0;
+    pxHeap->xHeapFreeBytesTotal = 0;
+    pxHeap->xFreeBytesRemaining = 0;
+    pxHeap->xMinimumEverFreeBytesRemaining = 0;
+    pxHeap->xNumberOfSuccessfulAllocations = pxHeap->xNumberOfSuccessfulFrees = 0;
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    pxHeap->pvPendingFree = NULL;
+#endif
+#if EASY_CONFIG_HEAP_STATS
+    memset(pxHeap->xAllocSizeHistogram, 0, sizeof(pxHeap->xAllocSizeHistogram));
+    memset(pxHeap->xMallocWalkHistogram, 0, sizeof(pxHeap->xMallocWalkHistogram));
+    memset(pxHeap->xFreeWalkHistogram, 0, sizeof(pxHeap->xFreeWalkHistogram));
+#endif
+
+    // Safety check: validate heap pointer and size
+    if (heap == NULL || size < (TLSF_BLOCK_SIZE_MIN + TLSF_BLOCK_OVERHEAD + TLSF_ALIGN_SIZE))
+    {
+        // Invalid parameters, do not initialize
+        return;
+    }
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxAddress = ((uintptr_t)heap + TLSF_ALIGN_MASK) & ~(uintptr_t)TLSF_ALIGN_MASK;
+    xPoolSize = (size - (easy_heap_size_t)(uxAddress - (uintptr_t)heap) - TLSF_BLOCK_OVERHEAD) & ~TLSF_ALIGN_MASK;
+
+    /* A single free block can not exceed the largest first level range. */
+    if (xPoolSize >= TLSF_BLOCK_SIZE_MAX)
+    {
+        xPoolSize = TLSF_BLOCK_SIZE_MAX - TLSF_ALIGN_SIZE;
+    }
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by the end marker. */
+    pxFirstFreeBlock = (void *)uxAddress;
+    pxFirstFreeBlock->xBlockSize = xPoolSize | TLSF_BLOCK_FREE;
+    pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+
+    /* The end marker is a zero sized used block, it stops merging at the end
+     * of the heap space. */
+    pxEnd = prvBlockNext(pxFirstFreeBlock);
+    pxEnd->xBlockSize = TLSF_BLOCK_PREV_FREE;
+    pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+
+    prvInsertFreeBlock(pxHeap, pxFirstFreeBlock);
+
+    pxHeap->xMinimumEverFreeBytesRemaining = xPoolSize;
+    pxHeap->xFreeBytesRemaining = xPoolSize;
+    pxHeap->xHeapFreeBytesTotal = xPoolSize;
+
+    pxHeap->xHeapAddress = uxAddress;
+    pxHeap->xHeapSize = size;
+}
+#endif // EASY_CONFIG_FUNCTION_HEAP && EASY_CONFIG_HEAP_TLSF
@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_mpmc_ringbuffer.h"
+
+#define MPMC_RINGBUFFER_SLOT(_ringbuf, _index) ((uint32_t *)((_ringbuf)->buffer + (size_t)((_index) & ((_ringbuf)->total_size - 1)) * (_ringbuf)->slot_size))
+
+int easy_mpmc_ringbuffer_init(easy_mpmc_ringbuffer_t *ringbuf, uint32_t total_size, uint32_t item_size, void *buffer)
+{
+    /* With one slot the sequence of the next round equals the published
+     * one, a second put would overwrite the item nobody got yet. */
+    if (total_size < 2 || (total_size & (total_size - 1)) != 0)
+    {
+        return -1;
+    }
+
+    ringbuf->total_size = total_size;
+    ringbuf->slot_size = EASY_MPMC_RINGBUFFER_SLOT_SIZE(item_size);
+    ringbuf->item_size = item_size;
+    ringbuf->buffer = buffer;
+    ringbuf->enqueue_index = 0;
+    ringbuf->dequeue_index = 0;
+
+    /* slot i is free for the producer of index i */
+    for (uint32_t i = 0; i < total_size; i++)
+    {
+        *MPMC_RINGBUFFER_SLOT(ringbuf, i) = i;
+    }
+
+    return 0;
+}
+
+uint32_t easy_mpmc_ringbuffer_enqueue_get(easy_mpmc_ringbuffer_t *ringbuf, void **mem)
+{
+    uint32_t index = EASY_ATOMIC_LOAD(&ringbuf->enqueue_index, EASY_ATOMIC_RELAXED);
+    uint32_t *slot;
+
+    do
+    {
+        slot = MPMC_RINGBUFFER_SLOT(ringbuf, index);
+        int32_t diff = (int32_t)(EASY_ATOMIC_LOAD(slot, EASY_ATOMIC_ACQUIRE) - index);
+
+        if (diff < 0)
+        {
+            /* the slot still holds the item of the previous round */
+            *mem = NULL;
+            return 0;
+        }
+
+        if (diff > 0)
+        {
+            /* another producer took it, retry from the current index */
+            index = EASY_ATOMIC_LOAD(&ringbuf->enqueue_index, EASY_ATOMIC_RELAXED);
+            continue;
+        }
+
+        /* the slot sequence orders the data, the CAS itself can be relaxed */
+        if (EASY_ATOMIC_CAS(&ringbuf->enqueue_index, &index, index + 1, EASY_ATOMIC_RELAXED))
+        {
+            break;
+        }
+    } while (1);
+
+    *mem = slot + 1;
+    return index;
+}
+
+void easy_mpmc_ringbuffer_enqueue(easy_mpmc_ringbuffer_t *ringbuf, uint32_t index)
+{
+    EASY_ATOMIC_STORE(MPMC_RINGBUFFER_SLOT(ringbuf, index), index + 1, EASY_ATOMIC_RELEASE);
+}
+
+void *easy_mpmc_ringbuffer_dequeue_peek(easy_mpmc_ringbuffer_t *ringbuf, uint32_t *index)
+{
+    uint32_t dequeue_index = EASY_ATOMIC_LOAD(&ringbuf->dequeue_index, EASY_ATOMIC_RELAXED);
+    uint32_t *slot;
+
+    do
+    {
+        slot = MPMC_RINGBUFFER_SLOT(ringbuf, dequeue_index);
+        int32_t diff = (int32_t)(EASY_ATOMIC_LOAD(slot, EASY_ATOMIC_ACQUIRE) - (dequeue_index + 1));
+
+        if (diff < 0)
+        {
+            /* not published yet */
+            return NULL;
+        }
+
+        if (diff > 0)
+        {
+            /* another consumer took it, retry from the current index */
+            dequeue_index = EASY_ATOMIC_LOAD(&ringbuf->dequeue_index, EASY_ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (EASY_ATOMIC_CAS(&ringbuf->dequeue_index, &dequeue_index, dequeue_index + 1, EASY_ATOMIC_RELAXED))
+        {
+            break;
+        }
+    } while (1);
+
+    *index = dequeue_index;
+    return slot + 1;
+}
+
+void easy_mpmc_ringbuffer_dequeue(easy_mpmc_ringbuffer_t *ringbuf, uint32_t index)
+{
+    /* free for the producer of the next round */
+    EASY_ATOMIC_STORE(MPMC_RINGBUFFER_SLOT(ringbuf, index), index + ringbuf->total_size, EASY_ATOMIC_RELEASE);
+}
+
+int easy_mpmc_ringbuffer_put(easy_mpmc_ringbuffer_t *ringbuf, const void *buffer)
+{
+    void *mem;
+    uint32_t index = easy_mpmc_ringbuffer_enqueue_get(ringbuf, &mem);
+
+    if (mem == NULL)
+    {
+        return 0;
+    }
+
+    memcpy(mem, buffer, ringbuf->item_size);
+    easy_mpmc_ringbuffer_enqueue(ringbuf, index);
+
+    return 1;
+}
+
+int easy_mpmc_ringbuffer_get(easy_mpmc_ringbuffer_t *ringbuf, void *buffer)
+{
+    uint32_t index;
+    void *mem = easy_mpmc_ringbuffer_dequeue_peek(ringbuf, &index);
+
+    if (mem == NULL)
+    {
+        return 0;
+    }
+
+    if (buffer != NULL)
+    {
+        memcpy(buffer, mem, ringbuf->item_size);
+    }
+    easy_mpmc_ringbuffer_dequeue(ringbuf, index);
+
+    return 1;
+}
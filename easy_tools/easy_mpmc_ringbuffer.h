@@ -0,0 +1,165 @@
+#ifndef _EASY_MPMC_RINGBUFFER_H_
+#define _EASY_MPMC_RINGBUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "easy_tools_common.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Every slot is a sequence number and the item, rounded up to 4 bytes. */
+#define EASY_MPMC_RINGBUFFER_SLOT_SIZE(_item_size) (sizeof(uint32_t) + (((uint32_t)(_item_size) + 3) & ~(uint32_t)3))
+
+/**
+ * @brief   Lock-free multi producer multi consumer RINGBUF of fixed size items.
+ * @details Bounded queue with a sequence number per slot (D. Vyukov). A
+ *   producer claims a slot with a CAS on enqueue_index once the slot sequence
+ *   says it is free, fills it and publishes it by storing the next sequence. A
+ *   consumer does the same on dequeue_index and gives the slot back by storing
+ *   the sequence of the next round. Producers and consumers only share the
+ *   slot they use, the two indices live on their own cache lines.
+ *   The indices run freely over uint32_t, so total_size must be a power of 2,
+ *   at least 2.
+ */
+typedef struct easy_mpmc_ringbuffer
+{
+    uint32_t total_size; /* Number of buffers, a power of 2 */
+    uint32_t slot_size;  /* Stride between slots, see EASY_MPMC_RINGBUFFER_SLOT_SIZE */
+    uint32_t item_size;  /* Bytes copied by put/get */
+    uint8_t *buffer;
+
+    uint32_t enqueue_index __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Write. Next slot to claim */
+    uint32_t dequeue_index __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Read. Next slot to claim */
+} easy_mpmc_ringbuffer_t;
+
+/* The slot sequences are not static data, EASY_MPMC_RINGBUFFER_INIT must run before use. */
+#define EASY_MPMC_RINGBUFFER_DEFINE(_name, _num, _data_size)                                                                                                   \
+    static uint32_t _name##_data_storage[(_num) * (EASY_MPMC_RINGBUFFER_SLOT_SIZE(_data_size) / sizeof(uint32_t))];                                            \
+    static easy_mpmc_ringbuffer_t _name
+
+#define EASY_MPMC_RINGBUFFER_INIT(_name, _num, _data_size) easy_mpmc_ringbuffer_init(&_name, _num, _data_size, (void *)_name##_data_storage)
+
+/**
+ * @brief  Initialize the RINGBUF, no thread may use it at that time.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] total_size: The number of items, a power of 2 of at least 2.
+ * @param  [in] item_size: The size of an item.
+ * @param  [in] buffer: The buffer to be used, total_size *
+ *         EASY_MPMC_RINGBUFFER_SLOT_SIZE(item_size) bytes aligned to 4.
+ * @return 0 on success, -1 if total_size is not a power of 2 or is 1.
+ */
+int easy_mpmc_ringbuffer_init(easy_mpmc_ringbuffer_t *ringbuf, uint32_t total_size, uint32_t item_size, void *buffer);
+
+/**
+ * @brief  Returns the number of items of the RINGBUF.
+ */
+static inline uint32_t easy_mpmc_ringbuffer_total_size(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    return ringbuf->total_size;
+}
+
+/**
+ * @brief  Returns the item size of the RINGBUF in bytes.
+ */
+static inline uint32_t easy_mpmc_ringbuffer_item_size(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    return ringbuf->item_size;
+}
+
+/**
+ * @brief  Returns the number of claimed items, it is a snapshot when other
+ *         threads are running.
+ */
+static inline uint32_t easy_mpmc_ringbuffer_size(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    uint32_t dequeue_index = EASY_ATOMIC_LOAD(&ringbuf->dequeue_index, EASY_ATOMIC_ACQUIRE);
+    int32_t size = (int32_t)(EASY_ATOMIC_LOAD(&ringbuf->enqueue_index, EASY_ATOMIC_ACQUIRE) - dequeue_index);
+
+    /* both indices may move between the loads */
+    return size < 0 ? 0 : EASY_MIN((uint32_t)size, ringbuf->total_size);
+}
+
+/**
+ * @brief  Returns the number of free items, a snapshot like easy_mpmc_ringbuffer_size.
+ */
+static inline uint32_t easy_mpmc_ringbuffer_reserve_size(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    return ringbuf->total_size - easy_mpmc_ringbuffer_size(ringbuf);
+}
+
+/**
+ * @brief  Check if the RINGBUF is empty.
+ */
+static inline int easy_mpmc_ringbuffer_is_empty(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    return easy_mpmc_ringbuffer_size(ringbuf) == 0;
+}
+
+/**
+ * @brief  Check if the RINGBUF is full.
+ */
+static inline int easy_mpmc_ringbuffer_is_full(easy_mpmc_ringbuffer_t *ringbuf)
+{
+    return easy_mpmc_ringbuffer_size(ringbuf) == ringbuf->total_size;
+}
+
+/**
+ * @brief  Put an item into the RINGBUF, from any thread.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The item, item_size bytes.
+ * @return The number of items put into the RINGBUF, 0 if it is full.
+ */
+int easy_mpmc_ringbuffer_put(easy_mpmc_ringbuffer_t *ringbuf, const void *buffer);
+
+/**
+ * @brief  Get an item from the RINGBUF, from any thread.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to get the item, may be NULL to drop it.
+ * @return The number of items get from the RINGBUF, 0 if it is empty.
+ */
+int easy_mpmc_ringbuffer_get(easy_mpmc_ringbuffer_t *ringbuf, void *buffer);
+
+/**
+ * @brief   Claim a free slot to be filled in place.
+ * @details The slot is owned by the caller until easy_mpmc_ringbuffer_enqueue,
+ *   consumers wait for it (get returns 0) when they reach it, so fill it fast.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] mem: The slot item, NULL if the RINGBUF is full.
+ * @return The index of the slot, only valid if mem != NULL.
+ */
+uint32_t easy_mpmc_ringbuffer_enqueue_get(easy_mpmc_ringbuffer_t *ringbuf, void **mem);
+
+/**
+ * @brief  Publish a slot claimed by easy_mpmc_ringbuffer_enqueue_get.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] index: The index returned by easy_mpmc_ringbuffer_enqueue_get.
+ */
+void easy_mpmc_ringbuffer_enqueue(easy_mpmc_ringbuffer_t *ringbuf, uint32_t index);
+
+/**
+ * @brief   Claim the oldest item to be used in place.
+ * @details Unlike easy_data_ringbuffer_dequeue_peek the item is taken, no other
+ *   consumer sees it. The slot is not reused until easy_mpmc_ringbuffer_dequeue.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] index: The index of the slot.
+ * @return The item, NULL if the RINGBUF is empty.
+ */
+void *easy_mpmc_ringbuffer_dequeue_peek(easy_mpmc_ringbuffer_t *ringbuf, uint32_t *index);
+
+/**
+ * @brief  Give back a slot claimed by easy_mpmc_ringbuffer_dequeue_peek.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] index: The index returned by easy_mpmc_ringbuffer_dequeue_peek.
+ */
+void easy_mpmc_ringbuffer_dequeue(easy_mpmc_ringbuffer_t *ringbuf, uint32_t index);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EASY_MPMC_RINGBUFFER_H_ */
@@ -5,11 +5,32 @@
 #include "easy_api.h"
 #include "easy_heap.h"
 #include "easy_msg.h"
+#include "easy_slab.h"
 
-void *easy_msg_alloc_len(uint16_t id, uint16_t const param_len)
+static const struct easy_msg_allocator *msg_allocator;
+
+void easy_msg_set_allocator(const struct easy_msg_allocator *allocator)
 {
+    msg_allocator = allocator;
+}
+
+void *easy_msg_alloc_len_from(const struct easy_msg_allocator *allocator, uint16_t id, uint16_t const param_len)
+{
+    struct easy_msg *msg;
+
     __easy_disable_isr();
-    struct easy_msg *msg = (struct easy_msg *)easy_heap_malloc(sizeof(struct easy_msg) + param_len);
+    if (allocator != NULL)
+    {
+        msg = (struct easy_msg *)allocator->alloc(allocator->ctx, sizeof(struct easy_msg) + param_len);
+    }
+    else
+    {
+#if EASY_CONFIG_FUNCTION_MSG_SLAB
+        msg = (struct easy_msg *)easy_slab_malloc(sizeof(struct easy_msg) + param_len);
+#else
+        msg = (struct easy_msg *)easy_heap_malloc(sizeof(struct easy_msg) + param_len);
+#endif
+    }
     __easy_enable_isr();
 
     if (msg == NULL)
@@ -19,15 +40,16 @@ void *easy_msg_alloc_len(uint16_t id, uint16_t const param_len)
 
     memset(msg, 0, sizeof(struct easy_msg) + param_len);
 
+    msg->allocator = allocator;
     msg->id = id;
     msg->param_len = param_len;
 
     return msg;
 }
 
-void *easy_msg_alloc(uint16_t id, uint16_t const param_len, void *param)
+void *easy_msg_alloc_from(const struct easy_msg_allocator *allocator, uint16_t id, uint16_t const param_len, void *param)
 {
-    struct easy_msg *msg = easy_msg_alloc_len(id, param_len);
+    struct easy_msg *msg = easy_msg_alloc_len_from(allocator, id, param_len);
 
     if (msg == NULL)
     {
@@ -39,9 +61,35 @@ void *easy_msg_alloc(uint16_t id, uint16_t const param_len, void *param)
     return msg;
 }
 
+void *easy_msg_alloc_len(uint16_t id, uint16_t const param_len)
+{
+    return easy_msg_alloc_len_from(msg_allocator, id, param_len);
+}
+
+void *easy_msg_alloc(uint16_t id, uint16_t const param_len, void *param)
+{
+    return easy_msg_alloc_from(msg_allocator, id, param_len, param);
+}
+
 void easy_msg_free(struct easy_msg *msg)
 {
+    if (msg == NULL)
+    {
+        return;
+    }
+
     __easy_disable_isr();
-    easy_heap_free(msg);
+    if (msg->allocator != NULL)
+    {
+        msg->allocator->free(msg->allocator->ctx, msg, sizeof(struct easy_msg) + msg->param_len);
+    }
+    else
+    {
+#if EASY_CONFIG_FUNCTION_MSG_SLAB
+        easy_slab_free(msg, sizeof(struct easy_msg) + msg->param_len);
+#else
+        easy_heap_free(msg);
+#endif
+    }
     __easy_enable_isr();
 }
@@ -7,11 +7,32 @@
 
 #include "easy_dlist.h"
 
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /** Define -------------------------------------------------------------------*/
+/**
+ * @brief   Allocator of the messages.
+ * @details alloc and free get ctx as the first argument, size is the whole
+ *   message size. Both are called with the interrupts disabled. Ready made
+ *   backends: easy_heap_hook_xxx (ctx is a heap instance, NULL is the default
+ *   heap), easy_pool_hook_xxx (ctx is an easy_pool_t) and easy_arena_hook_xxx
+ *   (ctx is an easy_arena_t).
+ */
+struct easy_msg_allocator
+{
+    void *(*alloc)(void *ctx, uint32_t size);
+    void (*free)(void *ctx, void *ptr, uint32_t size);
+    void *ctx;
+};
+
 typedef struct easy_msg
 {
     easy_dnode_t node;
 
+    const struct easy_msg_allocator *allocator; ///< The allocator the message comes from, NULL is the default.
     uint16_t id;
     uint16_t param_len;
     uint8_t param[]; ///< Parameter embedded struct. Must be word-aligned.
@@ -20,6 +41,34 @@ typedef struct easy_msg
 /** Exported functions -------------------------------------------------------*/
 void *easy_msg_alloc_len(uint16_t id, uint16_t const param_len);
 void *easy_msg_alloc(uint16_t id, uint16_t const param_len, void *param);
+
+/**
+ * @brief  Free the message to the allocator it comes from.
+ */
 void easy_msg_free(struct easy_msg *msg);
 
+/**
+ * @brief  Allocate a message from the given allocator.
+ * @param  [in] allocator: The allocator, NULL is the default heap (or slab).
+ * @param  [in] id: The message id.
+ * @param  [in] param_len: The length of the parameter.
+ * @return The message with a zeroed parameter, NULL if failed.
+ */
+void *easy_msg_alloc_len_from(const struct easy_msg_allocator *allocator, uint16_t id, uint16_t const param_len);
+void *easy_msg_alloc_from(const struct easy_msg_allocator *allocator, uint16_t id, uint16_t const param_len, void *param);
+
+/**
+ * @brief  Set the allocator used by easy_msg_alloc/easy_msg_alloc_len, NULL
+ *         restores the default heap (or slab) allocator. Every message
+ *         remembers its allocator, so it may be changed at any time.
+ * @param  [in] allocator: The allocator, it must stay valid while its
+ *         messages are not freed.
+ */
+void easy_msg_set_allocator(const struct easy_msg_allocator *allocator);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*!< _EASY_MSG_H_ */
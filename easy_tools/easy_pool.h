@@ -1,8 +1,102 @@
 #ifndef _EASY_POOL_H_
 #define _EASY_POOL_H_
 
+#include <string.h>
+
 #include "easy_data_ringbuffer.h"
 
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if EASY_CONFIG_POOL_INTRUSIVE
+/**
+ * @brief   Pool with the free list threaded through the free items.
+ * @details A free item holds the pointer to the next free one, so alloc/free
+ *   are a load and a store on the head, and the last freed item (still hot in
+ *   cache) is reused first. Items are rounded up to pointers. Unlike the FIFO
+ *   mode, alloc and free must not run on different threads at the same time.
+ */
+typedef struct easy_pool
+{
+    void *free_list;     /* First free item, NULL if none */
+    uint16_t free_count; /* Number of free items */
+    uint16_t total_size; /* Number of items */
+    uint16_t item_size;
+} easy_pool_t;
+
+/* Item stride in pointers, a free item holds the next pointer. */
+#define EASY_POOL_ITEM_WORDS(_data_size) ((EASY_MROUND(_data_size) + sizeof(void *) - 1) / sizeof(void *))
+
+static inline int easy_pool_list_get(easy_pool_t *spool, void **item)
+{
+    void *head = spool->free_list;
+
+    if (head == NULL)
+    {
+        return 0;
+    }
+
+    memcpy(&spool->free_list, head, sizeof(void *));
+    spool->free_count--;
+    *item = head;
+
+    return 1;
+}
+
+static inline int easy_pool_list_put(easy_pool_t *spool, void *item)
+{
+    memcpy(item, &spool->free_list, sizeof(void *));
+    spool->free_list = item;
+    spool->free_count++;
+
+    return 1;
+}
+
+#define EASY_POOL_ENQUEUE(_spool, _val) easy_pool_list_put(_spool, (void *)(_val))
+
+#define EASY_POOL_DEQUEUE(_spool, _val) easy_pool_list_get(_spool, (void **)&(_val))
+
+#define EASY_POOL_IS_EMPTY(_spool) ((_spool)->free_count == 0)
+
+#define EASY_POOL_IS_FULL(_spool) ((_spool)->free_count == (_spool)->total_size)
+
+#define EASY_POOL_SIZE(_spool) (_spool)->free_count
+
+#define EASY_POOL_RESERVE_SIZE(_spool) ((_spool)->total_size - (_spool)->free_count)
+
+#define EASY_POOL_TOTAL_CNT(_spool) (_spool)->total_size
+
+#define EASY_POOL_ITEM_SIZE(_spool) (_spool)->item_size
+
+#define EASY_POOL_DEFINE(_name, _num, _data_size)                                                                                                              \
+    static easy_pool_t _name;                                                                                                                                  \
+    static void *_name##_data_storage[_num][EASY_POOL_ITEM_WORDS(_data_size)];
+
+#define EASY_POOL_INIT(_name, _num, _data_size) easy_pool_init(&_name, NULL, (uint8_t *)_name##_data_storage, _num, _data_size)
+
+/**
+ * @brief  Initialize the pool, fifo_storage is not used in this mode, the
+ *         items in data_storage are EASY_POOL_ITEM_WORDS(data_item_size)
+ *         pointers apart.
+ */
+static inline void easy_pool_init(easy_pool_t *spool, void **fifo_storage, uint8_t *data_storage, uint16_t n, uint16_t data_item_size)
+{
+    (void)fifo_storage;
+    spool->item_size = data_item_size;
+    spool->total_size = n;
+    spool->free_count = 0;
+    spool->free_list = NULL;
+
+    // push from the end, so the first alloc gets the first item
+    for (int i = n - 1; i >= 0; i--)
+    {
+        void *data_item = (void *)(data_storage + EASY_POOL_ITEM_WORDS(data_item_size) * sizeof(void *) * i);
+        EASY_POOL_ENQUEUE(spool, data_item);
+    }
+}
+#else
 typedef struct easy_pool
 {
     easy_data_ringbuffer_t ringbuf;
@@ -45,4 +139,36 @@ static inline void easy_pool_init(easy_pool_t *spool, void **fifo_storage, uint8
     }
 }
 
+#endif
+
+/**
+ * @brief  Allocator hook adapters, ctx is the pool. Allocations larger than
+ *         the item size fail.
+ */
+static inline void *easy_pool_hook_alloc(void *ctx, uint32_t size)
+{
+    easy_pool_t *spool = (easy_pool_t *)ctx;
+    void *data_item;
+
+    if (size > spool->item_size || !EASY_POOL_DEQUEUE(spool, data_item))
+    {
+        return NULL;
+    }
+
+    return data_item;
+}
+
+static inline void easy_pool_hook_free(void *ctx, void *ptr, uint32_t size)
+{
+    easy_pool_t *spool = (easy_pool_t *)ctx;
+
+    (void)size;
+    EASY_POOL_ENQUEUE(spool, ptr);
+}
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _EASY_POOL_H_ */
@@ -0,0 +1,290 @@
+#ifndef _EASY_RING_HPP_
+#define _EASY_RING_HPP_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief   Typed header-only versions of easy_data_ringbuffer, easy_ringbuffer
+ *          and easy_pool.
+ * @details The capacity and the item type are template parameters, so the
+ *   compiler sees the stride and the wrap point as constants: the index
+ *   arithmetic folds (a mask when N is a power of 2, the mirrored indices of
+ *   the C version otherwise) and the copies are inlined. The algorithms and
+ *   the thread rules are the ones of the C types.
+ */
+namespace easy
+{
+
+namespace detail
+{
+
+/* Indices run in [0, 2 * N) like easy_data_ringbuffer, or freely with a mask when N is a power of 2. */
+template <uint32_t N>
+struct ring_index
+{
+    static_assert(N > 0 && N <= 0x7fffffffu, "ring capacity must be in [1, 2^31)");
+
+    static constexpr bool pow2 = (N & (N - 1)) == 0;
+
+    static uint32_t size(uint32_t read_index, uint32_t write_index)
+    {
+        if (pow2)
+        {
+            return write_index - read_index;
+        }
+        return write_index >= read_index ? write_index - read_index : (N << 1) - (read_index - write_index);
+    }
+
+    static uint32_t ptr(uint32_t index)
+    {
+        if (pow2)
+        {
+            return index & (N - 1);
+        }
+        return index >= N ? index - N : index;
+    }
+
+    static uint32_t add(uint32_t index, uint32_t n)
+    {
+        if (pow2)
+        {
+            return index + n;
+        }
+        uint32_t rest = (N << 1) - index;
+        return n >= rest ? n - rest : index + n;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief   Ring of N items of type T, easy_data_ringbuffer with a constant
+ *          stride.
+ * @details One writer and one reader, with the same rules as easy_data_ringbuffer.
+ */
+template <typename T, uint32_t N>
+class ring
+{
+public:
+    static constexpr uint32_t capacity()
+    {
+        return N;
+    }
+
+    uint32_t size() const
+    {
+        return index::size(read_index_, write_index_);
+    }
+
+    uint32_t reserve_size() const
+    {
+        return N - size();
+    }
+
+    bool empty() const
+    {
+        return read_index_ == write_index_;
+    }
+
+    bool full() const
+    {
+        return size() == N;
+    }
+
+    void reset()
+    {
+        read_index_ = 0;
+        write_index_ = 0;
+    }
+
+    /**
+     * @brief  Put an item, false if the ring is full.
+     */
+    bool put(const T &item)
+    {
+        if (full())
+        {
+            return false;
+        }
+
+        buffer_[index::ptr(write_index_)] = item;
+        write_index_ = index::add(write_index_, 1);
+        return true;
+    }
+
+    /**
+     * @brief  Get an item, false if the ring is empty.
+     */
+    bool get(T &item)
+    {
+        if (empty())
+        {
+            return false;
+        }
+
+        item = buffer_[index::ptr(read_index_)];
+        read_index_ = index::add(read_index_, 1);
+        return true;
+    }
+
+    /**
+     * @brief  Put up to n items, returns the number of items put.
+     */
+    uint32_t put_n(const T *items, uint32_t n)
+    {
+        uint32_t wptr = index::ptr(write_index_);
+
+        n = std::min(n, reserve_size());
+
+        /* first up to the buffer end, then the rest (if any) at the beginning */
+        uint32_t l = std::min(n, N - wptr);
+        std::copy(items, items + l, buffer_ + wptr);
+        std::copy(items + l, items + n, buffer_);
+
+        write_index_ = index::add(write_index_, n);
+        return n;
+    }
+
+    /**
+     * @brief  Get up to n items, returns the number of items got.
+     */
+    uint32_t get_n(T *items, uint32_t n)
+    {
+        uint32_t rptr = index::ptr(read_index_);
+
+        n = std::min(n, size());
+
+        uint32_t l = std::min(n, N - rptr);
+        std::copy(buffer_ + rptr, buffer_ + rptr + l, items);
+        std::copy(buffer_, buffer_ + (n - l), items + l);
+
+        read_index_ = index::add(read_index_, n);
+        return n;
+    }
+
+    /**
+     * @brief  The oldest item, nullptr if the ring is empty.
+     */
+    T *front()
+    {
+        return empty() ? nullptr : &buffer_[index::ptr(read_index_)];
+    }
+
+    /**
+     * @brief  Drop the oldest item, after front().
+     */
+    void pop()
+    {
+        if (!empty())
+        {
+            read_index_ = index::add(read_index_, 1);
+        }
+    }
+
+private:
+    typedef detail::ring_index<N> index;
+
+    uint32_t read_index_ = 0;  /* Read. Read index */
+    uint32_t write_index_ = 0; /* Write. Write index */
+    T buffer_[N];
+};
+
+/**
+ * @brief   Ring of N bytes, easy_ringbuffer with a constant size.
+ * @details put and get move as many bytes as possible and return the count,
+ *   like easy_ringbuffer_put/easy_ringbuffer_get.
+ */
+template <uint32_t N>
+class byte_ring : public ring<uint8_t, N>
+{
+public:
+    uint32_t put(const uint8_t *buffer, uint32_t len)
+    {
+        return this->put_n(buffer, len);
+    }
+
+    uint32_t get(uint8_t *buffer, uint32_t len)
+    {
+        return this->get_n(buffer, len);
+    }
+};
+
+/**
+ * @brief   Pool of N items of type T, easy_pool with the storage inside.
+ * @details The free items are kept in a ring of pointers like easy_pool, so
+ *   they are reused in FIFO order. alloc/free hand out raw storage,
+ *   create/destroy also run the constructor and the destructor.
+ */
+template <typename T, uint32_t N>
+class pool
+{
+public:
+    pool()
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            free_.put(reinterpret_cast<T *>(&storage_[i]));
+        }
+    }
+
+    pool(const pool &) = delete;
+    pool &operator=(const pool &) = delete;
+
+    static constexpr uint32_t capacity()
+    {
+        return N;
+    }
+
+    /**
+     * @brief  Returns the number of free items.
+     */
+    uint32_t available() const
+    {
+        return free_.size();
+    }
+
+    /**
+     * @brief  Take a free item, nullptr if there is none.
+     */
+    T *alloc()
+    {
+        T *item;
+
+        return free_.get(item) ? item : nullptr;
+    }
+
+    /**
+     * @brief  Give an item back.
+     */
+    void free(T *item)
+    {
+        free_.put(item);
+    }
+
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        T *item = alloc();
+
+        return item ? new (item) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T *item)
+    {
+        item->~T();
+        free(item);
+    }
+
+private:
+    ring<T *, N> free_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_[N];
+};
+
+} // namespace easy
+
+#endif /* _EASY_RING_HPP_ */
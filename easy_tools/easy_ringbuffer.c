@@ -1,8 +1,36 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* memfd_create */
+#endif
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "easy_ringbuffer.h"
+#include "easy_tools_common.h"
+
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+#ifndef __linux__
+#error "EASY_CONFIG_RINGBUFFER_MIRRORED needs Linux memfd_create and mmap"
+#endif
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+#ifndef __linux__
+#error "EASY_CONFIG_RINGBUFFER_WAIT needs Linux futex"
+#endif
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
 
 #ifndef MIN
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
@@ -10,27 +38,134 @@
 
 #define RINGBUFFER_INDEX_TO_PTR(_index, _total_size) ((_index >= _total_size) ? (_index - _total_size) : (_index))
 
+static inline uint32_t ringbuffer_index_to_ptr(easy_ringbuffer_t *ringbuf, uint32_t index)
+{
+    if (ringbuf->mask)
+    {
+        return index & ringbuf->mask;
+    }
+
+    return RINGBUFFER_INDEX_TO_PTR(index, ringbuf->total_size);
+}
+
+static inline uint32_t ringbuffer_index_add(easy_ringbuffer_t *ringbuf, uint32_t index, uint32_t len)
+{
+    index += len;
+
+    /* free running indices wrap by themselves */
+    if (!ringbuf->mask && index >= (ringbuf->total_size << 1))
+    {
+        index -= (ringbuf->total_size << 1);
+    }
+
+    return index;
+}
+
+static inline uint32_t ringbuffer_index_size(easy_ringbuffer_t *ringbuf, uint32_t read_index, uint32_t write_index)
+{
+    if (ringbuf->mask || write_index >= read_index)
+    {
+        return write_index - read_index;
+    }
+
+    return (ringbuf->total_size << 1) - (read_index - write_index);
+}
+
+/* Bytes that can be copied at ptr in one go, up to the buffer end unless the buffer is mapped twice. */
+static inline uint32_t ringbuffer_linear_size(easy_ringbuffer_t *ringbuf, uint32_t ptr, uint32_t len)
+{
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+    if (ringbuf->mirrored)
+    {
+        return len;
+    }
+#endif
+
+    return MIN(len, ringbuf->total_size - ptr);
+}
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+static void ringbuffer_futex_wake(uint32_t *index)
+{
+    syscall(SYS_futex, index, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+}
+#endif
+
+/* Called after len bytes were added, for the watermark and the waiting readers. */
+static inline void ringbuffer_written(easy_ringbuffer_t *ringbuf, uint32_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+    if (ringbuf->watermark_callback != NULL)
+    {
+        uint32_t size = easy_ringbuffer_size(ringbuf);
+
+        if (size >= ringbuf->high_watermark && size < ringbuf->high_watermark + len)
+        {
+            ringbuf->watermark_callback(ringbuf, 1);
+        }
+    }
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+    /* pairs with the waiter count update, so either the waiter sees the index or we see the waiter */
+    EASY_ATOMIC_THREAD_FENCE(EASY_ATOMIC_SEQ_CST);
+    if (EASY_ATOMIC_LOAD(&ringbuf->read_waiters, EASY_ATOMIC_RELAXED))
+    {
+        ringbuffer_futex_wake(&ringbuf->write_index);
+    }
+#endif
+}
+
+/* Called after len bytes were removed, for the watermark and the waiting writers. */
+static inline void ringbuffer_read(easy_ringbuffer_t *ringbuf, uint32_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+    if (ringbuf->watermark_callback != NULL && ringbuf->low_watermark != EASY_RINGBUFFER_WATERMARK_OFF)
+    {
+        uint32_t size = easy_ringbuffer_size(ringbuf);
+
+        if (size <= ringbuf->low_watermark && size + len > ringbuf->low_watermark)
+        {
+            ringbuf->watermark_callback(ringbuf, 0);
+        }
+    }
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+    EASY_ATOMIC_THREAD_FENCE(EASY_ATOMIC_SEQ_CST);
+    if (EASY_ATOMIC_LOAD(&ringbuf->write_waiters, EASY_ATOMIC_RELAXED))
+    {
+        ringbuffer_futex_wake(&ringbuf->read_index);
+    }
+#endif
+}
+
 uint32_t easy_ringbuffer_put(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len)
 {
     uint32_t l;
-    uint32_t write_index;
-    uint32_t wptr = RINGBUFFER_INDEX_TO_PTR(ringbuf->write_index, ringbuf->total_size);
+    uint32_t wptr = ringbuffer_index_to_ptr(ringbuf, ringbuf->write_index);
 
     len = MIN(len, easy_ringbuffer_reserve_size(ringbuf));
 
     /* first put the data starting from ringbuf->write_index to buffer end */
-    l = MIN(len, ringbuf->total_size - wptr);
+    l = ringbuffer_linear_size(ringbuf, wptr, len);
     memcpy(ringbuf->buffer + wptr, buffer, l);
 
     /* then put the rest (if any) at the beginning of the buffer */
     memcpy(ringbuf->buffer, buffer + l, len - l);
 
-    write_index = ringbuf->write_index + len;
-    if (write_index >= (ringbuf->total_size << 1))
-    {
-        write_index -= (ringbuf->total_size << 1);
-    }
-    ringbuf->write_index = write_index;
+    EASY_RINGBUFFER_STORE_INDEX(ringbuf->write_index, ringbuffer_index_add(ringbuf, ringbuf->write_index, len));
+    ringbuffer_written(ringbuf, len);
 
     return len;
 }
@@ -38,24 +173,419 @@ uint32_t easy_ringbuffer_put(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32
 uint32_t easy_ringbuffer_get(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len)
 {
     uint32_t l;
-    uint32_t read_index;
-    uint32_t rptr = RINGBUFFER_INDEX_TO_PTR(ringbuf->read_index, ringbuf->total_size);
+    uint32_t rptr = ringbuffer_index_to_ptr(ringbuf, ringbuf->read_index);
 
     len = MIN(len, easy_ringbuffer_size(ringbuf));
 
     /* first get the data from ringbuf->read_index until the end of the buffer */
-    l = MIN(len, ringbuf->total_size - rptr);
+    l = ringbuffer_linear_size(ringbuf, rptr, len);
     memcpy(buffer, ringbuf->buffer + rptr, l);
 
     /* then get the rest (if any) from the beginning of the buffer */
     memcpy(buffer + l, ringbuf->buffer, len - l);
 
-    read_index = ringbuf->read_index + len;
-    if (read_index >= (ringbuf->total_size << 1))
+    EASY_RINGBUFFER_STORE_INDEX(ringbuf->read_index, ringbuffer_index_add(ringbuf, ringbuf->read_index, len));
+    ringbuffer_read(ringbuf, len);
+
+    return len;
+}
+
+static uint32_t ringbuffer_spans(easy_ringbuffer_t *ringbuf, uint32_t index, uint32_t len, easy_ringbuffer_span_t spans[2])
+{
+    uint32_t ptr = ringbuffer_index_to_ptr(ringbuf, index);
+
+    spans[0].ptr = ringbuf->buffer + ptr;
+    spans[0].len = ringbuffer_linear_size(ringbuf, ptr, len);
+    spans[1].ptr = ringbuf->buffer;
+    spans[1].len = len - spans[0].len;
+
+    return len;
+}
+
+uint32_t easy_ringbuffer_write_acquire_spans(easy_ringbuffer_t *ringbuf, easy_ringbuffer_span_t spans[2], uint32_t max)
+{
+    return ringbuffer_spans(ringbuf, ringbuf->write_index, MIN(max, easy_ringbuffer_reserve_size(ringbuf)), spans);
+}
+
+uint32_t easy_ringbuffer_write_acquire(easy_ringbuffer_t *ringbuf, uint8_t **ptr, uint32_t max)
+{
+    easy_ringbuffer_span_t spans[2];
+
+    easy_ringbuffer_write_acquire_spans(ringbuf, spans, max);
+    *ptr = spans[0].ptr;
+
+    return spans[0].len;
+}
+
+uint32_t easy_ringbuffer_write_commit(easy_ringbuffer_t *ringbuf, uint32_t len)
+{
+    len = MIN(len, easy_ringbuffer_reserve_size(ringbuf));
+    EASY_RINGBUFFER_STORE_INDEX(ringbuf->write_index, ringbuffer_index_add(ringbuf, ringbuf->write_index, len));
+    ringbuffer_written(ringbuf, len);
+
+    return len;
+}
+
+uint32_t easy_ringbuffer_read_acquire_spans(easy_ringbuffer_t *ringbuf, easy_ringbuffer_span_t spans[2], uint32_t max)
+{
+    return ringbuffer_spans(ringbuf, ringbuf->read_index, MIN(max, easy_ringbuffer_size(ringbuf)), spans);
+}
+
+uint32_t easy_ringbuffer_read_acquire(easy_ringbuffer_t *ringbuf, uint8_t **ptr, uint32_t max)
+{
+    easy_ringbuffer_span_t spans[2];
+
+    easy_ringbuffer_read_acquire_spans(ringbuf, spans, max);
+    *ptr = spans[0].ptr;
+
+    return spans[0].len;
+}
+
+uint32_t easy_ringbuffer_read_release(easy_ringbuffer_t *ringbuf, uint32_t len)
+{
+    len = MIN(len, easy_ringbuffer_size(ringbuf));
+    EASY_RINGBUFFER_STORE_INDEX(ringbuf->read_index, ringbuffer_index_add(ringbuf, ringbuf->read_index, len));
+    ringbuffer_read(ringbuf, len);
+
+    return len;
+}
+
+uint32_t easy_ringbuffer_put_overwrite(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len)
+{
+    uint32_t l;
+    uint32_t drop = 0;
+    uint32_t room_drop;
+    uint32_t read_index;
+    uint32_t write_index = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_RELAXED);
+    uint32_t wptr = ringbuffer_index_to_ptr(ringbuf, write_index);
+
+    /* only the newest total_size bytes can be kept */
+    if (len > ringbuf->total_size)
     {
-        read_index -= (ringbuf->total_size << 1);
+        drop = len - ringbuf->total_size;
+        buffer += drop;
+        len = ringbuf->total_size;
     }
-    ringbuf->read_index = read_index;
+
+    /* make room by moving the read index, a reader copying that data sees its CAS fail */
+    do
+    {
+        read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+        room_drop = ringbuffer_index_size(ringbuf, read_index, write_index) + len;
+        room_drop = room_drop > ringbuf->total_size ? room_drop - ringbuf->total_size : 0;
+    } while (room_drop && !EASY_ATOMIC_CAS(&ringbuf->read_index, &read_index, ringbuffer_index_add(ringbuf, read_index, room_drop), EASY_ATOMIC_ACQ_REL));
+
+    drop += room_drop;
+    if (drop)
+    {
+        EASY_ATOMIC_FETCH_ADD(&ringbuf->dropped, drop, EASY_ATOMIC_RELAXED);
+    }
+
+    /* first put the data starting from ringbuf->write_index to buffer end */
+    l = ringbuffer_linear_size(ringbuf, wptr, len);
+    memcpy(ringbuf->buffer + wptr, buffer, l);
+
+    /* then put the rest (if any) at the beginning of the buffer */
+    memcpy(ringbuf->buffer, buffer + l, len - l);
+
+    EASY_ATOMIC_STORE(&ringbuf->write_index, ringbuffer_index_add(ringbuf, write_index, len), EASY_ATOMIC_RELEASE);
+    ringbuffer_written(ringbuf, len - room_drop);
 
     return len;
 }
+
+uint32_t easy_ringbuffer_get_overwrite(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len)
+{
+    uint32_t l;
+    uint32_t n;
+    uint32_t rptr;
+    uint32_t read_index;
+    uint32_t write_index;
+
+    /* copy, then claim the data, start again if the writer moved the read index meanwhile */
+    do
+    {
+        read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+        write_index = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_ACQUIRE);
+        rptr = ringbuffer_index_to_ptr(ringbuf, read_index);
+        n = MIN(len, ringbuffer_index_size(ringbuf, read_index, write_index));
+
+        l = ringbuffer_linear_size(ringbuf, rptr, n);
+        memcpy(buffer, ringbuf->buffer + rptr, l);
+        memcpy(buffer + l, ringbuf->buffer, n - l);
+    } while (n && !EASY_ATOMIC_CAS(&ringbuf->read_index, &read_index, ringbuffer_index_add(ringbuf, read_index, n), EASY_ATOMIC_ACQ_REL));
+    ringbuffer_read(ringbuf, n);
+
+    return n;
+}
+
+uint32_t easy_ringbuffer_take_dropped(easy_ringbuffer_t *ringbuf)
+{
+    return EASY_ATOMIC_EXCHANGE(&ringbuf->dropped, 0, EASY_ATOMIC_RELAXED);
+}
+
+/* Find byte in [from, to) of the data in spans, memchr on each span. */
+static int32_t ringbuffer_spans_find(easy_ringbuffer_span_t spans[2], uint32_t from, uint32_t to, uint8_t byte)
+{
+    uint8_t *match;
+
+    if (from < spans[0].len)
+    {
+        match = memchr(spans[0].ptr + from, byte, MIN(to, spans[0].len) - from);
+        if (match != NULL)
+        {
+            return (int32_t)(match - spans[0].ptr);
+        }
+        from = spans[0].len;
+    }
+
+    if (from < to)
+    {
+        match = memchr(spans[1].ptr + (from - spans[0].len), byte, to - from);
+        if (match != NULL)
+        {
+            return (int32_t)(match - spans[1].ptr + spans[0].len);
+        }
+    }
+
+    return -1;
+}
+
+/* Compare the data in spans at offset with pattern, the data may go on in the second span. */
+static int ringbuffer_spans_equal(easy_ringbuffer_span_t spans[2], uint32_t offset, const uint8_t *pattern, uint32_t len)
+{
+    uint32_t l = 0;
+
+    if (offset < spans[0].len)
+    {
+        l = MIN(len, spans[0].len - offset);
+        if (memcmp(spans[0].ptr + offset, pattern, l) != 0)
+        {
+            return 0;
+        }
+        offset = spans[0].len;
+    }
+
+    return memcmp(spans[1].ptr + (offset - spans[0].len), pattern + l, len - l) == 0;
+}
+
+int32_t easy_ringbuffer_find(easy_ringbuffer_t *ringbuf, uint8_t byte)
+{
+    easy_ringbuffer_span_t spans[2];
+    uint32_t size = easy_ringbuffer_read_acquire_spans(ringbuf, spans, UINT32_MAX);
+
+    return ringbuffer_spans_find(spans, 0, size, byte);
+}
+
+int32_t easy_ringbuffer_find_pattern(easy_ringbuffer_t *ringbuf, const uint8_t *pattern, uint32_t len)
+{
+    easy_ringbuffer_span_t spans[2];
+    uint32_t size = easy_ringbuffer_read_acquire_spans(ringbuf, spans, UINT32_MAX);
+    int32_t offset = 0;
+
+    if (len == 0 || len > size)
+    {
+        return len == 0 ? 0 : -1;
+    }
+
+    /* jump between candidates with memchr on the first byte, then compare the rest */
+    while ((offset = ringbuffer_spans_find(spans, (uint32_t)offset, size - len + 1, pattern[0])) >= 0)
+    {
+        if (ringbuffer_spans_equal(spans, (uint32_t)offset + 1, pattern + 1, len - 1))
+        {
+            return offset;
+        }
+        offset++;
+    }
+
+    return -1;
+}
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+static int ringbuffer_wait(easy_ringbuffer_t *ringbuf, int readable, uint32_t min_bytes, uint32_t timeout_ms)
+{
+    /* readers sleep on the write index, writers on the read index */
+    uint32_t *index = readable ? &ringbuf->write_index : &ringbuf->read_index;
+    uint32_t *waiters = readable ? &ringbuf->read_waiters : &ringbuf->write_waiters;
+    struct timespec now, deadline, timeout;
+    int ret = -1;
+
+    min_bytes = MIN(min_bytes, ringbuf->total_size);
+    if (timeout_ms != EASY_RINGBUFFER_WAIT_FOREVER)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    EASY_ATOMIC_FETCH_ADD(waiters, 1, EASY_ATOMIC_SEQ_CST);
+    for (;;)
+    {
+        /* the futex only sleeps if the index still has this value */
+        uint32_t value = EASY_ATOMIC_LOAD(index, EASY_ATOMIC_ACQUIRE);
+        uint32_t size = readable ? easy_ringbuffer_size(ringbuf) : easy_ringbuffer_reserve_size(ringbuf);
+
+        if (size >= min_bytes)
+        {
+            ret = 0;
+            break;
+        }
+
+        if (timeout_ms == EASY_RINGBUFFER_WAIT_FOREVER)
+        {
+            syscall(SYS_futex, index, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timeout.tv_sec = deadline.tv_sec - now.tv_sec;
+        timeout.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (timeout.tv_nsec < 0)
+        {
+            timeout.tv_sec--;
+            timeout.tv_nsec += 1000000000;
+        }
+        if (timeout.tv_sec < 0)
+        {
+            break;
+        }
+        syscall(SYS_futex, index, FUTEX_WAIT_PRIVATE, value, &timeout, NULL, 0);
+    }
+    EASY_ATOMIC_FETCH_ADD(waiters, (uint32_t)-1, EASY_ATOMIC_RELAXED);
+
+    return ret;
+}
+
+int easy_ringbuffer_wait_readable(easy_ringbuffer_t *ringbuf, uint32_t min_bytes, uint32_t timeout_ms)
+{
+    return ringbuffer_wait(ringbuf, 1, min_bytes, timeout_ms);
+}
+
+int easy_ringbuffer_wait_writable(easy_ringbuffer_t *ringbuf, uint32_t min_bytes, uint32_t timeout_ms)
+{
+    return ringbuffer_wait(ringbuf, 0, min_bytes, timeout_ms);
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+int easy_ringbuffer_init_mirrored(easy_ringbuffer_t *ringbuf, uint32_t total_size)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (total_size + page_size - 1) / page_size * page_size;
+    uint8_t *base;
+    int fd;
+
+    if (size == 0 || size > UINT32_MAX / 2)
+    {
+        return -1;
+    }
+
+    fd = memfd_create("easy_ringbuffer", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    /* reserve both halves first, then map the same pages over each of them */
+    base = mmap(NULL, size << 1, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ftruncate(fd, (off_t)size) != 0 || base == MAP_FAILED || mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        if (base != MAP_FAILED)
+        {
+            munmap(base, size << 1);
+        }
+        close(fd);
+        return -1;
+    }
+
+    /* the mappings keep the memory */
+    close(fd);
+
+    easy_ringbuffer_init(ringbuf, (uint32_t)size, base);
+    ringbuf->mirrored = 1;
+
+    return 0;
+}
+
+void easy_ringbuffer_deinit_mirrored(easy_ringbuffer_t *ringbuf)
+{
+    if (ringbuf->mirrored)
+    {
+        munmap(ringbuf->buffer, (size_t)ringbuf->total_size << 1);
+        easy_ringbuffer_init(ringbuf, 0, NULL);
+    }
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+ssize_t easy_ringbuffer_read_from_fd(easy_ringbuffer_t *ringbuf, int fd, uint32_t max)
+{
+    easy_ringbuffer_span_t spans[2];
+    struct iovec iov[2];
+    ssize_t ret;
+
+    if (easy_ringbuffer_write_acquire_spans(ringbuf, spans, max) == 0)
+    {
+        return 0;
+    }
+
+    /* plain read is cheaper than a readv of one iovec */
+    if (spans[1].len == 0)
+    {
+        ret = read(fd, spans[0].ptr, spans[0].len);
+    }
+    else
+    {
+        iov[0].iov_base = spans[0].ptr;
+        iov[0].iov_len = spans[0].len;
+        iov[1].iov_base = spans[1].ptr;
+        iov[1].iov_len = spans[1].len;
+        ret = readv(fd, iov, 2);
+    }
+
+    if (ret > 0)
+    {
+        easy_ringbuffer_write_commit(ringbuf, (uint32_t)ret);
+    }
+
+    return ret;
+}
+
+ssize_t easy_ringbuffer_write_to_fd(easy_ringbuffer_t *ringbuf, int fd, uint32_t max)
+{
+    easy_ringbuffer_span_t spans[2];
+    struct iovec iov[2];
+    ssize_t ret;
+
+    if (easy_ringbuffer_read_acquire_spans(ringbuf, spans, max) == 0)
+    {
+        return 0;
+    }
+
+    if (spans[1].len == 0)
+    {
+        ret = write(fd, spans[0].ptr, spans[0].len);
+    }
+    else
+    {
+        iov[0].iov_base = spans[0].ptr;
+        iov[0].iov_len = spans[0].len;
+        iov[1].iov_base = spans[1].ptr;
+        iov[1].iov_len = spans[1].len;
+        ret = writev(fd, iov, 2);
+    }
+
+    if (ret > 0)
+    {
+        easy_ringbuffer_read_release(ringbuf, (uint32_t)ret);
+    }
+
+    return ret;
+}
+#endif
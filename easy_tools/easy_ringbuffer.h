@@ -4,17 +4,81 @@
 #include <stddef.h>
 #include <stdint.h>
 
-typedef struct easy_ringbuffer
+#include "easy_tools_common.h"
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+#include <sys/types.h>
+#endif
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct easy_ringbuffer easy_ringbuffer_t;
+
+/* Watermark callback, high is 1 when the used size rose to the high watermark, 0 when it fell to the low one. */
+typedef void (*easy_ringbuffer_watermark_func)(easy_ringbuffer_t *ringbuf, int high);
+
+/* Watermark that never triggers. */
+#define EASY_RINGBUFFER_WATERMARK_OFF UINT32_MAX
+
+/* Timeout of the waits to wait forever. */
+#define EASY_RINGBUFFER_WAIT_FOREVER UINT32_MAX
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+/* The other side may run in another thread, an index is stored after the data and loaded before it. */
+#define EASY_RINGBUFFER_LOAD_INDEX(_index) EASY_ATOMIC_LOAD(&(_index), EASY_ATOMIC_ACQUIRE)
+#define EASY_RINGBUFFER_STORE_INDEX(_index, _val) EASY_ATOMIC_STORE(&(_index), _val, EASY_ATOMIC_RELEASE)
+#else
+#define EASY_RINGBUFFER_LOAD_INDEX(_index) (_index)
+#define EASY_RINGBUFFER_STORE_INDEX(_index, _val) ((_index) = (_val))
+#endif
+
+/**
+ * @brief   RINGBUF of bytes.
+ * @details Any size works with mirrored indices in [0, 2 * total_size). When
+ *   total_size is a power of 2 the indices run free instead and are masked to
+ *   get the position, which saves the compares on every access. The mode is
+ *   picked by init (or DEFINE), the API is the same.
+ */
+struct easy_ringbuffer
 {
     uint32_t total_size;  /* Number of buffers */
     uint32_t read_index;  /* Read. Read index */
     uint32_t write_index; /* Write. Write index */
     uint8_t *buffer;
-} easy_ringbuffer_t;
+    uint32_t mask;    /* total_size - 1 for the power of 2 mode, 0 for mirrored indices */
+    uint32_t dropped; /* Bytes overwritten by easy_ringbuffer_put_overwrite before they were read */
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+    uint32_t mirrored; /* The buffer is mapped twice, see easy_ringbuffer_init_mirrored */
+#endif
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+    uint32_t high_watermark;
+    uint32_t low_watermark;
+    easy_ringbuffer_watermark_func watermark_callback;
+    void *user_data;
+#endif
+#if EASY_CONFIG_RINGBUFFER_WAIT
+    uint32_t read_waiters;  /* Threads waiting for data */
+    uint32_t write_waiters; /* Threads waiting for room */
+#endif
+};
+
+/* Contiguous part of the RINGBUF memory. */
+typedef struct easy_ringbuffer_span
+{
+    uint8_t *ptr;
+    uint32_t len;
+} easy_ringbuffer_span_t;
+
+/* Mask of a size, 0 when it is not a power of 2 (a size of 1 uses mirrored indices too). */
+#define EASY_RINGBUFFER_MASK(_num) ((((_num) > 1) && (((_num) & ((_num)-1)) == 0)) ? ((_num)-1) : 0)
 
 #define EASY_RINGBUFFER_DEFINE(_name, _num)                                                                                                                    \
     static uint8_t _name##_data_storage[_num];                                                                                                                 \
-    static easy_ringbuffer_t _name = {.total_size = _num, .write_index = 0, .read_index = 0, .buffer = (void *)_name##_data_storage}
+    static easy_ringbuffer_t _name = {                                                                                                                         \
+            .total_size = _num, .write_index = 0, .read_index = 0, .buffer = (void *)_name##_data_storage, .mask = EASY_RINGBUFFER_MASK(_num)}
 
 #define EASY_RINGBUFFER_INIT(_name, _num) easy_ringbuffer_init(&_name, _num, (void *)_name##_data_storage)
 
@@ -36,6 +100,7 @@ static inline void easy_ringbuffer_reset(easy_ringbuffer_t *ringbuf)
 {
     ringbuf->write_index = 0;
     ringbuf->read_index = 0;
+    ringbuf->dropped = 0;
 }
 
 /**
@@ -50,8 +115,43 @@ static inline void easy_ringbuffer_init(easy_ringbuffer_t *ringbuf, uint32_t tot
     ringbuf->write_index = 0;
     ringbuf->read_index = 0;
     ringbuf->buffer = buffer;
+    ringbuf->mask = EASY_RINGBUFFER_MASK(total_size);
+    ringbuf->dropped = 0;
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+    ringbuf->mirrored = 0;
+#endif
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+    ringbuf->high_watermark = EASY_RINGBUFFER_WATERMARK_OFF;
+    ringbuf->low_watermark = EASY_RINGBUFFER_WATERMARK_OFF;
+    ringbuf->watermark_callback = NULL;
+    ringbuf->user_data = NULL;
+#endif
+#if EASY_CONFIG_RINGBUFFER_WAIT
+    ringbuf->read_waiters = 0;
+    ringbuf->write_waiters = 0;
+#endif
 }
 
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+/**
+ * @brief   Initialize the RINGBUF on memory mapped twice back to back.
+ * @details The size is rounded up to the page size, the buffer is total_size
+ *   bytes of memory seen at buffer and at buffer + total_size. Every put/get
+ *   is then one memcpy and the acquire APIs always return one span, so the
+ *   data can be parsed or written to a file in place.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] total_size: The minimum size of the RINGBUF.
+ * @return 0 on success, -1 if the memory could not be mapped.
+ */
+int easy_ringbuffer_init_mirrored(easy_ringbuffer_t *ringbuf, uint32_t total_size);
+
+/**
+ * @brief  Unmap the memory of a RINGBUF from easy_ringbuffer_init_mirrored.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ */
+void easy_ringbuffer_deinit_mirrored(easy_ringbuffer_t *ringbuf);
+#endif
+
 /**
  * @brief  Check if the RINGBUF is empty.
  * @param  [in] ringbuf: The ringbuf to be used.
@@ -59,7 +159,7 @@ static inline void easy_ringbuffer_init(easy_ringbuffer_t *ringbuf, uint32_t tot
  */
 static inline int easy_ringbuffer_is_empty(easy_ringbuffer_t *ringbuf)
 {
-    return ringbuf->read_index == ringbuf->write_index;
+    return EASY_RINGBUFFER_LOAD_INDEX(ringbuf->read_index) == EASY_RINGBUFFER_LOAD_INDEX(ringbuf->write_index);
 }
 
 /**
@@ -69,8 +169,15 @@ static inline int easy_ringbuffer_is_empty(easy_ringbuffer_t *ringbuf)
  */
 static inline uint32_t easy_ringbuffer_size(easy_ringbuffer_t *ringbuf)
 {
-    return ringbuf->write_index >= ringbuf->read_index ? ringbuf->write_index - ringbuf->read_index
-                                                       : (ringbuf->total_size << 1) - (ringbuf->read_index - ringbuf->write_index);
+    uint32_t read_index = EASY_RINGBUFFER_LOAD_INDEX(ringbuf->read_index);
+    uint32_t write_index = EASY_RINGBUFFER_LOAD_INDEX(ringbuf->write_index);
+
+    if (ringbuf->mask)
+    {
+        return write_index - read_index;
+    }
+
+    return write_index >= read_index ? write_index - read_index : (ringbuf->total_size << 1) - (read_index - write_index);
 }
 
 /**
@@ -110,4 +217,192 @@ uint32_t easy_ringbuffer_put(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32
  */
 uint32_t easy_ringbuffer_get(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len);
 
+/**
+ * @brief   Put data into the RINGBUF, dropping the oldest data when it is full.
+ * @details Overwrite mode for streams where the newest data matters, the
+ *   writer never waits. The read index is moved with a CAS, so a reader using
+ *   easy_ringbuffer_get_overwrite on another thread or core notices it was
+ *   overrun. The dropped bytes are counted, see easy_ringbuffer_take_dropped.
+ *   Only one writer.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to be put into the RINGBUF.
+ * @param  [in] len: The length of the buffer, only the last total_size bytes
+ *         are kept when it is longer.
+ * @return The length of the buffer put into the RINGBUF.
+ */
+uint32_t easy_ringbuffer_put_overwrite(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len);
+
+/**
+ * @brief   Get data from a RINGBUF written by easy_ringbuffer_put_overwrite.
+ * @details The data is copied first and claimed with a CAS on the read index,
+ *   if the writer dropped it meanwhile the copy is done again from the new
+ *   read index. Only one reader.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to get the data.
+ * @param  [in] len: The length of the buffer.
+ * @return The length of the buffer get from the RINGBUF.
+ */
+uint32_t easy_ringbuffer_get_overwrite(easy_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len);
+
+/**
+ * @brief  Returns the bytes dropped by easy_ringbuffer_put_overwrite since the
+ *         last call, non-zero means the reader was overrun.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ */
+uint32_t easy_ringbuffer_take_dropped(easy_ringbuffer_t *ringbuf);
+
+/**
+ * @brief   Zero-copy write: get the free space of the RINGBUF in place.
+ * @details The space wraps at the end of the buffer, so it is returned as up
+ *   to two spans, the second one is empty when it does not wrap. Fill them
+ *   and call easy_ringbuffer_write_commit with the bytes written.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] spans: The free space, spans[0] first.
+ * @param  [in] max: The max length wanted.
+ * @return The total length of the spans.
+ */
+uint32_t easy_ringbuffer_write_acquire_spans(easy_ringbuffer_t *ringbuf, easy_ringbuffer_span_t spans[2], uint32_t max);
+
+/**
+ * @brief  Zero-copy write of one contiguous span, like the first span of
+ *         easy_ringbuffer_write_acquire_spans.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] ptr: The start of the free space.
+ * @param  [in] max: The max length wanted.
+ * @return The length that can be written at ptr.
+ */
+uint32_t easy_ringbuffer_write_acquire(easy_ringbuffer_t *ringbuf, uint8_t **ptr, uint32_t max);
+
+/**
+ * @brief  Commit bytes written in the acquired space, they can be read then.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] len: The bytes written, no more than the acquired length.
+ * @return The length committed.
+ */
+uint32_t easy_ringbuffer_write_commit(easy_ringbuffer_t *ringbuf, uint32_t len);
+
+/**
+ * @brief   Zero-copy read: get the data of the RINGBUF in place.
+ * @details Same as easy_ringbuffer_write_acquire_spans, for the used space.
+ *   Call easy_ringbuffer_read_release with the bytes consumed.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] spans: The data, spans[0] first.
+ * @param  [in] max: The max length wanted.
+ * @return The total length of the spans.
+ */
+uint32_t easy_ringbuffer_read_acquire_spans(easy_ringbuffer_t *ringbuf, easy_ringbuffer_span_t spans[2], uint32_t max);
+
+/**
+ * @brief  Zero-copy read of one contiguous span.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [out] ptr: The start of the data.
+ * @param  [in] max: The max length wanted.
+ * @return The length that can be read at ptr.
+ */
+uint32_t easy_ringbuffer_read_acquire(easy_ringbuffer_t *ringbuf, uint8_t **ptr, uint32_t max);
+
+/**
+ * @brief  Release bytes consumed from the acquired data, the space can be
+ *         written then.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] len: The bytes consumed, no more than the acquired length.
+ * @return The length released.
+ */
+uint32_t easy_ringbuffer_read_release(easy_ringbuffer_t *ringbuf, uint32_t len);
+
+/**
+ * @brief  Find a byte in the data of the RINGBUF without getting it, the
+ *         search goes on across the end of the buffer.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] byte: The byte to find, like '\n'.
+ * @return The offset of the first match from the read position, -1 if not
+ *         found. Getting offset + 1 bytes then gets the data up to the match.
+ */
+int32_t easy_ringbuffer_find(easy_ringbuffer_t *ringbuf, uint8_t byte);
+
+/**
+ * @brief  Find a pattern in the data of the RINGBUF without getting it, the
+ *         pattern may cross the end of the buffer.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] pattern: The pattern to find, like a sync word.
+ * @param  [in] len: The length of the pattern.
+ * @return The offset of the first match from the read position, -1 if not
+ *         found.
+ */
+int32_t easy_ringbuffer_find_pattern(easy_ringbuffer_t *ringbuf, const uint8_t *pattern, uint32_t len);
+
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+/**
+ * @brief   Set the watermark callback.
+ * @details The callback runs in the context of the put (or commit) that makes
+ *   the used size rise to high or more, and of the get (or release) that makes
+ *   it fall to low or less, so a consumer can be woken up or a producer
+ *   resumed instead of polling easy_ringbuffer_size.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] high: The high watermark, EASY_RINGBUFFER_WATERMARK_OFF for none.
+ * @param  [in] low: The low watermark, EASY_RINGBUFFER_WATERMARK_OFF for none.
+ * @param  [in] callback: The callback, NULL to stop.
+ * @param  [in] user_data: Kept in ringbuf->user_data for the callback.
+ */
+static inline void easy_ringbuffer_set_watermark(easy_ringbuffer_t *ringbuf, uint32_t high, uint32_t low, easy_ringbuffer_watermark_func callback,
+                                                 void *user_data)
+{
+    ringbuf->high_watermark = high;
+    ringbuf->low_watermark = low;
+    ringbuf->user_data = user_data;
+    ringbuf->watermark_callback = callback;
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+/**
+ * @brief   Sleep until the RINGBUF has at least min_bytes of data.
+ * @details The writer wakes the sleeping threads with a futex after it adds
+ *   data, that costs nothing while nobody waits.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] min_bytes: The data wanted, limited to the total size.
+ * @param  [in] timeout_ms: The max time to wait, EASY_RINGBUFFER_WAIT_FOREVER
+ *         for no limit.
+ * @return 0 when the data is there, -1 on timeout.
+ */
+int easy_ringbuffer_wait_readable(easy_ringbuffer_t *ringbuf, uint32_t min_bytes, uint32_t timeout_ms);
+
+/**
+ * @brief  Sleep until the RINGBUF has at least min_bytes of room, like
+ *         easy_ringbuffer_wait_readable.
+ */
+int easy_ringbuffer_wait_writable(easy_ringbuffer_t *ringbuf, uint32_t min_bytes, uint32_t timeout_ms);
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+/**
+ * @brief   Read from a file descriptor straight into the RINGBUF.
+ * @details One read on the free space, or one readv of two iovecs when it
+ *   wraps, so there is no copy through a temporary buffer.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] fd: The file descriptor to read from.
+ * @param  [in] max: The max length to read.
+ * @return The length read, 0 on end of file or when the RINGBUF is full, -1 on
+ *         error with errno set by readv.
+ */
+ssize_t easy_ringbuffer_read_from_fd(easy_ringbuffer_t *ringbuf, int fd, uint32_t max);
+
+/**
+ * @brief   Write the data of the RINGBUF straight to a file descriptor.
+ * @details One write of the data, or one writev of two iovecs when it wraps.
+ *   Only the bytes written are removed from the RINGBUF.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] fd: The file descriptor to write to.
+ * @param  [in] max: The max length to write.
+ * @return The length written, 0 when the RINGBUF is empty, -1 on error with
+ *         errno set by writev.
+ */
+ssize_t easy_ringbuffer_write_to_fd(easy_ringbuffer_t *ringbuf, int fd, uint32_t max);
+#endif
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _EASY_RINGBUFFER_H_ */
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_heap.h"
+#include "easy_slab.h"
+#include "easy_tools_common.h"
+
+#if EASY_CONFIG_FUNCTION_HEAP
+
+/* Every page starts with a link to the next page of the same class, the rest
+ * of the page is carved into objects of the class size. */
+struct easy_slab_page
+{
+    struct easy_slab_page *next;
+};
+
+/* Free objects are linked through their first word. */
+struct easy_slab_object
+{
+    struct easy_slab_object *next;
+};
+
+struct easy_slab_class
+{
+    struct easy_slab_object *free_list;
+    struct easy_slab_page *pages;
+    struct easy_slab_stats stats;
+};
+
+#define SLAB_ALIGN(_x) (((uint32_t)(_x) + sizeof(void *) - 1) & ~((uint32_t)sizeof(void *) - 1))
+
+#define SLAB_PAGE_HEADER_SIZE SLAB_ALIGN(sizeof(struct easy_slab_page))
+
+#define SLAB_ITEM_SIZE(_index) SLAB_ALIGN(EASY_MAX(slab_class_size[_index], sizeof(struct easy_slab_object)))
+
+static const uint16_t slab_class_size[] = EASY_CONFIG_HEAP_SLAB_SIZES;
+
+#define SLAB_CLASS_COUNT EASY_ARRAY_SIZE(slab_class_size)
+
+static struct easy_slab_class slab_class[SLAB_CLASS_COUNT];
+
+/* Pseudo class which counts the requests falling through to the heap. */
+static struct easy_slab_stats slab_fallthrough;
+
+static int _slab_class_index(uint32_t size)
+{
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        if (size <= slab_class_size[i])
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int _slab_refill(int index)
+{
+    struct easy_slab_class *cls = &slab_class[index];
+    uint32_t item_size = SLAB_ITEM_SIZE(index);
+    struct easy_slab_page *page = easy_heap_malloc(SLAB_PAGE_HEADER_SIZE + item_size * EASY_CONFIG_HEAP_SLAB_ITEMS_PER_PAGE);
+    uint8_t *item;
+
+    if (page == NULL)
+    {
+        return 0;
+    }
+
+    page->next = cls->pages;
+    cls->pages = page;
+    cls->stats.pages++;
+
+    /* Link the objects in address order, the lowest one is used first. */
+    item = (uint8_t *)page + SLAB_PAGE_HEADER_SIZE + item_size * (EASY_CONFIG_HEAP_SLAB_ITEMS_PER_PAGE - 1);
+    for (int i = 0; i < EASY_CONFIG_HEAP_SLAB_ITEMS_PER_PAGE; i++)
+    {
+        struct easy_slab_object *obj = (struct easy_slab_object *)item;
+        obj->next = cls->free_list;
+        cls->free_list = obj;
+        item -= item_size;
+    }
+
+    return 1;
+}
+
+void *easy_slab_malloc(uint32_t size)
+{
+    struct easy_slab_class *cls;
+    struct easy_slab_object *obj;
+    int index = _slab_class_index(size);
+    void *ptr;
+
+    if (index < 0)
+    {
+        ptr = easy_heap_malloc(size);
+        if (ptr == NULL)
+        {
+            slab_fallthrough.alloc_failed++;
+            return NULL;
+        }
+        slab_fallthrough.alloc_refills++;
+        slab_fallthrough.in_use++;
+        return ptr;
+    }
+
+    cls = &slab_class[index];
+    if (cls->free_list != NULL)
+    {
+        cls->stats.alloc_hits++;
+    }
+    else if (_slab_refill(index))
+    {
+        cls->stats.alloc_refills++;
+    }
+    else
+    {
+        cls->stats.alloc_failed++;
+        return NULL;
+    }
+
+    obj = cls->free_list;
+    cls->free_list = obj->next;
+    cls->stats.in_use++;
+
+    return obj;
+}
+
+void easy_slab_free(void *ptr, uint32_t size)
+{
+    struct easy_slab_class *cls;
+    struct easy_slab_object *obj = ptr;
+    int index;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    index = _slab_class_index(size);
+    if (index < 0)
+    {
+        slab_fallthrough.frees++;
+        slab_fallthrough.in_use--;
+        easy_heap_free(ptr);
+        return;
+    }
+
+    cls = &slab_class[index];
+    obj->next = cls->free_list;
+    cls->free_list = obj;
+    cls->stats.frees++;
+    cls->stats.in_use--;
+}
+
+void easy_slab_reclaim(void)
+{
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        struct easy_slab_class *cls = &slab_class[i];
+
+        /* Objects have no back link to their page, so pages are only given
+         * back once every object of the class is free. */
+        if (cls->stats.in_use != 0)
+        {
+            continue;
+        }
+
+        while (cls->pages != NULL)
+        {
+            struct easy_slab_page *page = cls->pages;
+            cls->pages = page->next;
+            easy_heap_free(page);
+        }
+        cls->free_list = NULL;
+        cls->stats.pages = 0;
+    }
+}
+
+int easy_slab_check_empty(void)
+{
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        if (slab_class[i].stats.in_use != 0)
+        {
+            return 0;
+        }
+    }
+
+    return slab_fallthrough.in_use == 0;
+}
+
+int easy_slab_get_class_count(void)
+{
+    return SLAB_CLASS_COUNT;
+}
+
+int easy_slab_get_stats(int index, struct easy_slab_stats *stats)
+{
+    if (index < 0 || index > SLAB_CLASS_COUNT)
+    {
+        return -1;
+    }
+
+    if (index == SLAB_CLASS_COUNT)
+    {
+        *stats = slab_fallthrough;
+        return 0;
+    }
+
+    *stats = slab_class[index].stats;
+    stats->item_size = SLAB_ITEM_SIZE(index);
+    return 0;
+}
+
+void easy_slab_init(void)
+{
+    memset(slab_class, 0, sizeof(slab_class));
+    memset(&slab_fallthrough, 0, sizeof(slab_fallthrough));
+}
+
+#endif // EASY_CONFIG_FUNCTION_HEAP
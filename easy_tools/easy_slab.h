@@ -0,0 +1,84 @@
+#ifndef _EASY_SLAB_H_
+#define _EASY_SLAB_H_
+
+/** Includes -----------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Define -------------------------------------------------------------------*/
+
+/**
+ * @brief   Statistics of one slab size class.
+ * @details alloc_hits are allocations served from the class free list,
+ *   alloc_refills are allocations that had to carve a new page from the heap,
+ *   so the hit rate of a class is alloc_hits / (alloc_hits + alloc_refills).
+ */
+struct easy_slab_stats
+{
+    uint32_t item_size;     /* Object size of this class, 0 for the heap fallthrough */
+    uint32_t alloc_hits;    /* Allocations served from the free list */
+    uint32_t alloc_refills; /* Allocations which needed a new page */
+    uint32_t alloc_failed;  /* Allocations failed because the heap is full */
+    uint32_t frees;         /* Number of frees */
+    uint32_t in_use;        /* Objects allocated and not freed yet */
+    uint32_t pages;         /* Pages owned by this class */
+};
+
+/** Exported functions -------------------------------------------------------*/
+
+/**
+ * @brief  Allocate memory, small sizes are served from the slab classes,
+ *         larger sizes fall through to easy_heap_malloc.
+ * @param  [in] size: The wanted size in bytes.
+ * @return The allocated memory, NULL if failed.
+ */
+void *easy_slab_malloc(uint32_t size);
+
+/**
+ * @brief  Free memory allocated by easy_slab_malloc.
+ * @param  [in] ptr: The memory to be freed.
+ * @param  [in] size: The same size used to allocate the memory.
+ */
+void easy_slab_free(void *ptr, uint32_t size);
+
+/**
+ * @brief  Return the pages of the idle classes to the heap.
+ */
+void easy_slab_reclaim(void);
+
+/**
+ * @brief  Check if no object is allocated from the slab classes.
+ * @return 1 if all the classes are idle, 0 otherwise.
+ */
+int easy_slab_check_empty(void);
+
+/**
+ * @brief  Returns the number of slab size classes.
+ */
+int easy_slab_get_class_count(void);
+
+/**
+ * @brief  Get statistics of a size class.
+ * @param  [in] index: The class index, easy_slab_get_class_count() is the heap
+ *         fallthrough pseudo class.
+ * @param  [out] stats: The statistics.
+ * @return 0 if success, -1 if index is invalid.
+ */
+int easy_slab_get_stats(int index, struct easy_slab_stats *stats);
+
+/**
+ * @brief  Reset the slab state, the heap must be initialized again before.
+ */
+void easy_slab_init(void);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*!< _EASY_SLAB_H_ */
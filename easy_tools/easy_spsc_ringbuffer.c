@@ -0,0 +1,84 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "easy_spsc_ringbuffer.h"
+
+#define SPSC_RINGBUFFER_INDEX_TO_PTR(_index, _total_size) ((_index >= _total_size) ? (_index - _total_size) : (_index))
+
+uint32_t easy_spsc_ringbuffer_put(easy_spsc_ringbuffer_t *ringbuf, const uint8_t *buffer, uint32_t len)
+{
+    uint32_t l;
+    uint32_t write_index = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_RELAXED);
+    uint32_t wptr = SPSC_RINGBUFFER_INDEX_TO_PTR(write_index, ringbuf->total_size);
+    uint32_t reserve = ringbuf->total_size - easy_spsc_ringbuffer_index_size(ringbuf->total_size, ringbuf->read_index_cache, write_index);
+
+    /* Only look at the consumer line when the cached index is not enough. */
+    if (reserve < len)
+    {
+        ringbuf->read_index_cache = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+        reserve = ringbuf->total_size - easy_spsc_ringbuffer_index_size(ringbuf->total_size, ringbuf->read_index_cache, write_index);
+    }
+
+    len = EASY_MIN(len, reserve);
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    /* first put the data starting from write_index to buffer end */
+    l = EASY_MIN(len, ringbuf->total_size - wptr);
+    memcpy(ringbuf->buffer + wptr, buffer, l);
+
+    /* then put the rest (if any) at the beginning of the buffer */
+    memcpy(ringbuf->buffer, buffer + l, len - l);
+
+    write_index += len;
+    if (write_index >= (ringbuf->total_size << 1))
+    {
+        write_index -= (ringbuf->total_size << 1);
+    }
+
+    /* The data must be visible before the new index. */
+    EASY_ATOMIC_STORE(&ringbuf->write_index, write_index, EASY_ATOMIC_RELEASE);
+
+    return len;
+}
+
+uint32_t easy_spsc_ringbuffer_get(easy_spsc_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len)
+{
+    uint32_t l;
+    uint32_t read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_RELAXED);
+    uint32_t rptr = SPSC_RINGBUFFER_INDEX_TO_PTR(read_index, ringbuf->total_size);
+    uint32_t size = easy_spsc_ringbuffer_index_size(ringbuf->total_size, read_index, ringbuf->write_index_cache);
+
+    /* Only look at the producer line when the cached index is not enough. */
+    if (size < len)
+    {
+        ringbuf->write_index_cache = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_ACQUIRE);
+        size = easy_spsc_ringbuffer_index_size(ringbuf->total_size, read_index, ringbuf->write_index_cache);
+    }
+
+    len = EASY_MIN(len, size);
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    /* first get the data from read_index until the end of the buffer */
+    l = EASY_MIN(len, ringbuf->total_size - rptr);
+    memcpy(buffer, ringbuf->buffer + rptr, l);
+
+    /* then get the rest (if any) from the beginning of the buffer */
+    memcpy(buffer + l, ringbuf->buffer, len - l);
+
+    read_index += len;
+    if (read_index >= (ringbuf->total_size << 1))
+    {
+        read_index -= (ringbuf->total_size << 1);
+    }
+
+    /* The data must be read before the space is given back. */
+    EASY_ATOMIC_STORE(&ringbuf->read_index, read_index, EASY_ATOMIC_RELEASE);
+
+    return len;
+}
@@ -0,0 +1,134 @@
+#ifndef _EASY_SPSC_RINGBUFFER_H_
+#define _EASY_SPSC_RINGBUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "easy_tools_common.h"
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Lock-free single producer single consumer RINGBUF of bytes.
+ * @details One thread puts and one thread gets without any lock, the indices
+ *   are published with release stores and read with acquire loads. Every side
+ *   owns a cache line with its index and a cached copy of the other side's
+ *   index, the other side's line is only read when the cached copy says the
+ *   buffer is full (or empty). The indices run in [0, 2 * total_size) like
+ *   easy_ringbuffer, so all the bytes can be used.
+ */
+typedef struct easy_spsc_ringbuffer
+{
+    uint32_t total_size; /* Number of buffers */
+    uint8_t *buffer;
+
+    /* Producer line. */
+    uint32_t write_index __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Write. Write index */
+    uint32_t read_index_cache;                                           /* Write. Last read index seen */
+
+    /* Consumer line. */
+    uint32_t read_index __EASY_ALIGNED__(EASY_CONFIG_CACHE_LINE_SIZE); /* Read. Read index */
+    uint32_t write_index_cache;                                         /* Read. Last write index seen */
+} easy_spsc_ringbuffer_t;
+
+#define EASY_SPSC_RINGBUFFER_DEFINE(_name, _num)                                                                                                               \
+    static uint8_t _name##_data_storage[_num];                                                                                                                 \
+    static easy_spsc_ringbuffer_t _name = {.total_size = _num, .buffer = (void *)_name##_data_storage}
+
+#define EASY_SPSC_RINGBUFFER_INIT(_name, _num) easy_spsc_ringbuffer_init(&_name, _num, (void *)_name##_data_storage)
+
+/**
+ * @brief  Returns the used size of mirrored indices.
+ */
+static inline uint32_t easy_spsc_ringbuffer_index_size(uint32_t total_size, uint32_t read_index, uint32_t write_index)
+{
+    return write_index >= read_index ? write_index - read_index : (total_size << 1) - (read_index - write_index);
+}
+
+/**
+ * @brief  Initialize the RINGBUF, no thread may use it at that time.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] total_size: The total size of the RINGBUF.
+ * @param  [in] buffer: The buffer to be used.
+ */
+static inline void easy_spsc_ringbuffer_init(easy_spsc_ringbuffer_t *ringbuf, uint32_t total_size, uint8_t *buffer)
+{
+    ringbuf->total_size = total_size;
+    ringbuf->buffer = buffer;
+    ringbuf->write_index = 0;
+    ringbuf->read_index_cache = 0;
+    ringbuf->read_index = 0;
+    ringbuf->write_index_cache = 0;
+}
+
+/**
+ * @brief  Returns the size of the RINGBUF in bytes.
+ */
+static inline uint32_t easy_spsc_ringbuffer_total_size(easy_spsc_ringbuffer_t *ringbuf)
+{
+    return ringbuf->total_size;
+}
+
+/**
+ * @brief  Returns the used size of the RINGBUF in bytes, it is a snapshot when
+ *         the other side is running.
+ */
+static inline uint32_t easy_spsc_ringbuffer_size(easy_spsc_ringbuffer_t *ringbuf)
+{
+    uint32_t read_index = EASY_ATOMIC_LOAD(&ringbuf->read_index, EASY_ATOMIC_ACQUIRE);
+    uint32_t write_index = EASY_ATOMIC_LOAD(&ringbuf->write_index, EASY_ATOMIC_ACQUIRE);
+
+    return easy_spsc_ringbuffer_index_size(ringbuf->total_size, read_index, write_index);
+}
+
+/**
+ * @brief  Returns the free size of the RINGBUF in bytes.
+ */
+static inline uint32_t easy_spsc_ringbuffer_reserve_size(easy_spsc_ringbuffer_t *ringbuf)
+{
+    return ringbuf->total_size - easy_spsc_ringbuffer_size(ringbuf);
+}
+
+/**
+ * @brief  Check if the RINGBUF is empty.
+ */
+static inline int easy_spsc_ringbuffer_is_empty(easy_spsc_ringbuffer_t *ringbuf)
+{
+    return easy_spsc_ringbuffer_size(ringbuf) == 0;
+}
+
+/**
+ * @brief  Check if the RINGBUF is full.
+ */
+static inline int easy_spsc_ringbuffer_is_full(easy_spsc_ringbuffer_t *ringbuf)
+{
+    return easy_spsc_ringbuffer_size(ringbuf) == ringbuf->total_size;
+}
+
+/**
+ * @brief  Put data into the RINGBUF, only the producer thread may call it.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to be put into the RINGBUF.
+ * @param  [in] len: The length of the buffer.
+ * @return The length of the buffer put into the RINGBUF.
+ */
+uint32_t easy_spsc_ringbuffer_put(easy_spsc_ringbuffer_t *ringbuf, const uint8_t *buffer, uint32_t len);
+
+/**
+ * @brief  Get data from the RINGBUF, only the consumer thread may call it.
+ * @param  [in] ringbuf: The ringbuf to be used.
+ * @param  [in] buffer: The buffer to be put into the RINGBUF.
+ * @param  [in] len: The length of the buffer.
+ * @return The length of the buffer get from the RINGBUF.
+ */
+uint32_t easy_spsc_ringbuffer_get(easy_spsc_ringbuffer_t *ringbuf, uint8_t *buffer, uint32_t len);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EASY_SPSC_RINGBUFFER_H_ */
@@ -27,9 +27,30 @@ void easy_task_delete(struct easy_task *task)
     __easy_enable_isr();
 }
 
+void *easy_task_msg_alloc_len(struct easy_task *task, uint16_t id, uint16_t const param_len)
+{
+    if (task->allocator == NULL)
+    {
+        return easy_msg_alloc_len(id, param_len);
+    }
+
+    return easy_msg_alloc_len_from(task->allocator, id, param_len);
+}
+
+void *easy_task_msg_alloc(struct easy_task *task, uint16_t id, uint16_t const param_len, void *param)
+{
+    if (task->allocator == NULL)
+    {
+        return easy_msg_alloc(id, param_len, param);
+    }
+
+    return easy_msg_alloc_from(task->allocator, id, param_len, param);
+}
+
 void easy_task_create(struct easy_task *task)
 {
     easy_dlist_init(&(task->msg_list));
+    task->allocator = NULL;
     __easy_disable_isr();
     easy_dlist_append(&task_list, &task->node);
     __easy_enable_isr();
@@ -17,6 +17,11 @@
 #include "easy_dlist.h"
 #include "easy_msg.h"
 
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /** Define -------------------------------------------------------------------*/
 enum easy_task_hdl_result
 {
@@ -33,6 +38,8 @@ typedef struct easy_task
     easy_dnode_t msg_list;
 
     easy_task_func_t func;
+
+    const struct easy_msg_allocator *allocator; ///< Allocator of easy_task_msg_alloc, NULL uses the global one.
 } easy_task_t;
 
 /** Exported functions -------------------------------------------------------*/
@@ -43,10 +50,32 @@ void easy_task_delete(struct easy_task *task);
 
 void easy_task_create(struct easy_task *task);
 
+/**
+ * @brief  Set the allocator of the messages sent to the task, call it after
+ *         easy_task_create.
+ * @param  [in] task: The task.
+ * @param  [in] allocator: The allocator, NULL uses the easy_msg_set_allocator one.
+ */
+static inline void easy_task_set_allocator(struct easy_task *task, const struct easy_msg_allocator *allocator)
+{
+    task->allocator = allocator;
+}
+
+/**
+ * @brief  Allocate a message for the task from the allocator of the task.
+ */
+void *easy_task_msg_alloc_len(struct easy_task *task, uint16_t id, uint16_t const param_len);
+void *easy_task_msg_alloc(struct easy_task *task, uint16_t id, uint16_t const param_len, void *param);
+
 void easy_task_polling(void);
 
 int easy_task_check_empty(void);
 
 void easy_task_init(void);
 
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*!< _EASY_TASK_H_ */
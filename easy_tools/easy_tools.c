@@ -49,5 +49,6 @@ void easy_tools_init(void)
     struct easy_heap_ptr heap = {0};
     easy_tools_api_heap_init(&heap);
     easy_heap_init(heap.buf, heap.len);
+    easy_slab_init();
 #endif
 }
@@ -13,13 +13,19 @@
 #include "easy_dlist.h"
 #include "easy_slist.h"
 
+#include "easy_arena.h"
 #include "easy_heap.h"
 #include "easy_msg.h"
+#include "easy_slab.h"
 #include "easy_task.h"
 
+#include "easy_broadcast_ring.h"
 #include "easy_data_ringbuffer.h"
+#include "easy_frame_ring.h"
+#include "easy_mpmc_ringbuffer.h"
 #include "easy_pool.h"
 #include "easy_ringbuffer.h"
+#include "easy_spsc_ringbuffer.h"
 
 /* Set up for C function definitions, even when using C++ */
 #ifdef __cplusplus
@@ -76,6 +76,53 @@ extern "C" {
 
 #define __EASY_STATIC_INLINE__ static inline
 
+#define __EASY_ALIGNED__(_n) __attribute__((aligned(_n)))
+
+/**
+ * \brief           Atomic operations for the lock-free parts, map to the GCC
+ *                  __atomic builtins by default. Port can override them.
+ * \param[in]       _ptr: Pointer to the atomic variable
+ * \param[in]       _order: Memory order, one of EASY_ATOMIC_xxx order
+ */
+#define EASY_ATOMIC_RELAXED __ATOMIC_RELAXED
+#define EASY_ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#define EASY_ATOMIC_RELEASE __ATOMIC_RELEASE
+#define EASY_ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#define EASY_ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+#ifndef EASY_ATOMIC_LOAD
+#define EASY_ATOMIC_LOAD(_ptr, _order) __atomic_load_n(_ptr, _order)
+#endif
+
+#ifndef EASY_ATOMIC_STORE
+#define EASY_ATOMIC_STORE(_ptr, _val, _order) __atomic_store_n(_ptr, _val, _order)
+#endif
+
+#ifndef EASY_ATOMIC_EXCHANGE
+#define EASY_ATOMIC_EXCHANGE(_ptr, _val, _order) __atomic_exchange_n(_ptr, _val, _order)
+#endif
+
+#ifndef EASY_ATOMIC_FETCH_ADD
+#define EASY_ATOMIC_FETCH_ADD(_ptr, _val, _order) __atomic_fetch_add(_ptr, _val, _order)
+#endif
+
+#ifndef EASY_ATOMIC_FETCH_OR
+#define EASY_ATOMIC_FETCH_OR(_ptr, _val, _order) __atomic_fetch_or(_ptr, _val, _order)
+#endif
+
+#ifndef EASY_ATOMIC_FETCH_AND
+#define EASY_ATOMIC_FETCH_AND(_ptr, _val, _order) __atomic_fetch_and(_ptr, _val, _order)
+#endif
+
+#ifndef EASY_ATOMIC_THREAD_FENCE
+#define EASY_ATOMIC_THREAD_FENCE(_order) __atomic_thread_fence(_order)
+#endif
+
+/* Weak compare and swap, *_expected is updated with the current value if failed. */
+#ifndef EASY_ATOMIC_CAS
+#define EASY_ATOMIC_CAS(_ptr, _expected, _desired, _order) __atomic_compare_exchange_n(_ptr, _expected, _desired, 1, _order, EASY_ATOMIC_RELAXED)
+#endif
+
 #define EASY_MATH_PI 3.14159265358979323846f // pi
 
 #define EASY_MATH_COS(_phase) cos(_phase)
@@ -22,6 +22,228 @@ extern "C" {
 #define EASY_CONFIG_FUNCTION_TASK 1
 #endif
 
+/**
+ * Heap options.
+ * Use TLSF (two-level segregated fit) allocator for heap, malloc and free are
+ * O(1) with bitmap lookups. Default is the address-ordered first-fit allocator.
+ */
+#ifndef EASY_CONFIG_HEAP_TLSF
+#define EASY_CONFIG_HEAP_TLSF 0
+#endif
+
+/**
+ * Heap options.
+ * Default alignment of the first-fit heap blocks in bytes, must be a power of
+ * two. The TLSF heap always aligns to the pointer size, use
+ * easy_heap_aligned_alloc for larger alignment.
+ */
+#ifndef EASY_CONFIG_HEAP_BYTE_ALIGNMENT
+#define EASY_CONFIG_HEAP_BYTE_ALIGNMENT 4
+#endif
+
+/**
+ * Heap options.
+ * Record allocation size and free list walk length histograms for
+ * easy_heap_get_stats, it costs some cycles per malloc and free.
+ */
+#ifndef EASY_CONFIG_HEAP_STATS
+#define EASY_CONFIG_HEAP_STATS 0
+#endif
+
+/**
+ * Heap options.
+ * Use size_t for the heap sizes, so a heap can be larger than 2 GiB on 64-bit
+ * hosts. Default is uint32_t.
+ */
+#ifndef EASY_CONFIG_HEAP_SIZE_64BIT
+#define EASY_CONFIG_HEAP_SIZE_64BIT 0
+#endif
+
+/**
+ * Heap options.
+ * Default block search policy of the first-fit heap, 0 is first-fit, 1 is
+ * next-fit (roving pointer) and 2 is best-fit, see easy_heap_policy_t.
+ */
+#ifndef EASY_CONFIG_HEAP_POLICY
+#define EASY_CONFIG_HEAP_POLICY 0
+#endif
+
+/**
+ * Heap options.
+ * Max free list nodes the first-fit malloc visits, 0 is unlimited. When the
+ * limit is hit, the block is carved from a bump region reserved at the end of
+ * the heap instead. Once the region is used up, its rest joins the last free
+ * block and the block is carved from there, else malloc fails: no malloc walks
+ * more than the limit, so the latency stays bounded on large heaps.
+ */
+#ifndef EASY_CONFIG_HEAP_WALK_LIMIT
+#define EASY_CONFIG_HEAP_WALK_LIMIT 0
+#endif
+
+/**
+ * Heap options.
+ * With EASY_CONFIG_HEAP_WALK_LIMIT, walk the whole free list before failing a
+ * malloc, so it does not fail while a free block fits. The walk of such a
+ * malloc is no longer bounded.
+ */
+#ifndef EASY_CONFIG_HEAP_WALK_FALLBACK
+#define EASY_CONFIG_HEAP_WALK_FALLBACK 0
+#endif
+
+/**
+ * Heap options.
+ * Share of the heap reserved for the bump region in percent, only used with
+ * EASY_CONFIG_HEAP_WALK_LIMIT.
+ */
+#ifndef EASY_CONFIG_HEAP_BUMP_PERCENT
+#define EASY_CONFIG_HEAP_BUMP_PERCENT 25
+#endif
+
+/**
+ * Heap options.
+ * Deferred free, easy_heap_free only pushes the block to a lock-free pending
+ * list, the pending blocks are merged into the heap in one sorted batch at the
+ * next malloc or at easy_heap_collect. It keeps the critical section of a free
+ * short on bursty consumers.
+ */
+#ifndef EASY_CONFIG_HEAP_DEFERRED_FREE
+#define EASY_CONFIG_HEAP_DEFERRED_FREE 0
+#endif
+
+/**
+ * Heap options.
+ * TLSF second level lists count in log2, each power of two size range is split
+ * into (1 << EASY_CONFIG_HEAP_TLSF_SL_LOG2) lists. Max value is 5.
+ */
+#ifndef EASY_CONFIG_HEAP_TLSF_SL_LOG2
+#define EASY_CONFIG_HEAP_TLSF_SL_LOG2 3
+#endif
+
+/**
+ * Heap options.
+ * TLSF first level max index, the largest block is (1 << EASY_CONFIG_HEAP_TLSF_FL_MAX).
+ * Larger value can manage larger heap, but costs more control memory.
+ */
+#ifndef EASY_CONFIG_HEAP_TLSF_FL_MAX
+#define EASY_CONFIG_HEAP_TLSF_FL_MAX 24
+#endif
+
+/**
+ * Heap options.
+ * Per-thread heap cache for multi-threaded host (pthread). Every thread
+ * allocates from its own heap instance, frees from other threads are queued
+ * to the owner and released at its next malloc. Threads exceeding
+ * EASY_CONFIG_HEAP_THREAD_CACHE_MAX share the default heap with a lock.
+ */
+#ifndef EASY_CONFIG_HEAP_THREAD_CACHE
+#define EASY_CONFIG_HEAP_THREAD_CACHE 0
+#endif
+
+/**
+ * Heap options.
+ * Max number of per-thread heap caches.
+ */
+#ifndef EASY_CONFIG_HEAP_THREAD_CACHE_MAX
+#define EASY_CONFIG_HEAP_THREAD_CACHE_MAX 8
+#endif
+
+/**
+ * Heap options.
+ * Size of every per-thread heap cache in bytes, the caches are carved from the
+ * heap memory at init and use at most half of it.
+ */
+#ifndef EASY_CONFIG_HEAP_THREAD_CACHE_SIZE
+#define EASY_CONFIG_HEAP_THREAD_CACHE_SIZE 0x10000
+#endif
+
+/**
+ * Heap options.
+ * Slab size classes in bytes, must be in ascending order. Requests larger than
+ * the last class fall through to easy_heap_malloc.
+ */
+#ifndef EASY_CONFIG_HEAP_SLAB_SIZES
+#define EASY_CONFIG_HEAP_SLAB_SIZES {16, 32, 64, 128, 256}
+#endif
+
+/**
+ * Heap options.
+ * Number of objects carved from one heap page when a slab class is empty.
+ */
+#ifndef EASY_CONFIG_HEAP_SLAB_ITEMS_PER_PAGE
+#define EASY_CONFIG_HEAP_SLAB_ITEMS_PER_PAGE 4
+#endif
+
+/**
+ * Fuction options.
+ * Allocate msg from the slab classes instead of the heap directly.
+ */
+#ifndef EASY_CONFIG_FUNCTION_MSG_SLAB
+#define EASY_CONFIG_FUNCTION_MSG_SLAB 0
+#endif
+
+/**
+ * Buffer options.
+ * Cache line size in bytes, the producer and consumer indices of the lock-free
+ * buffers are kept on separate cache lines to avoid false sharing.
+ */
+#ifndef EASY_CONFIG_CACHE_LINE_SIZE
+#define EASY_CONFIG_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * Enable easy_ringbuffer_init_mirrored(), the buffer memory is mapped twice
+ * back to back so every window of the ringbuffer is contiguous. Linux only
+ * (memfd + mmap).
+ */
+#ifndef EASY_CONFIG_RINGBUFFER_MIRRORED
+#define EASY_CONFIG_RINGBUFFER_MIRRORED 0
+#endif
+
+/**
+ * Enable easy_ringbuffer_read_from_fd()/easy_ringbuffer_write_to_fd(), which
+ * move data between a file descriptor and the ringbuffer with one readv/writev.
+ * POSIX only.
+ */
+#ifndef EASY_CONFIG_RINGBUFFER_FD_IO
+#define EASY_CONFIG_RINGBUFFER_FD_IO 0
+#endif
+
+/**
+ * Enable the high/low watermark callback of easy_ringbuffer, see
+ * easy_ringbuffer_set_watermark().
+ */
+#ifndef EASY_CONFIG_RINGBUFFER_WATERMARK
+#define EASY_CONFIG_RINGBUFFER_WATERMARK 0
+#endif
+
+/**
+ * Enable easy_ringbuffer_wait_readable()/easy_ringbuffer_wait_writable(), a
+ * thread sleeps on a futex until the ringbuffer has enough data or room.
+ * The indices are then stored with release and loaded with acquire, so one
+ * reader and one writer may run in different threads. Linux only.
+ */
+#ifndef EASY_CONFIG_RINGBUFFER_WAIT
+#define EASY_CONFIG_RINGBUFFER_WAIT 0
+#endif
+
+/**
+ * Use 32-bit item counts and indices in easy_data_ringbuffer, for more than
+ * 32767 items or items larger than 64 KiB. Default is 16-bit, which keeps the
+ * control block small on MCUs.
+ */
+#ifndef EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT
+#define EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT 0
+#endif
+
+/**
+ * Keep the free items of easy_pool in a list threaded through the items
+ * (LIFO), instead of a ringbuffer of pointers (FIFO). No pointer array and
+ * O(1) alloc/free, but alloc and free must be on the same thread.
+ */
+#ifndef EASY_CONFIG_POOL_INTRUSIVE
+#define EASY_CONFIG_POOL_INTRUSIVE 0
+#endif
+
 /**
  * Debug options.
  * For log level. EASY_LOG_IMPL_LEVEL_NONE, EASY_LOG_IMPL_LEVEL_ERR,
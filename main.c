@@ -10,6 +10,14 @@ extern int example_user(void);
 extern void test_ringbuffer(void);
 extern void test_data_ringbuffer(void);
 extern void test_pool_ringbuffer(void);
+extern void test_spsc_ringbuffer(void);
+extern void test_mpmc_ringbuffer(void);
+extern void test_frame_ring(void);
+extern void test_broadcast_ring(void);
+extern void test_ring_cpp(void);
+
+extern void test_heap(void);
+extern void test_arena(void);
 
 extern void test_task(void);
 extern void test_task_polling(void);
@@ -24,6 +32,15 @@ static void test_work(void)
     test_ringbuffer();
     test_data_ringbuffer();
     test_pool_ringbuffer();
+    test_spsc_ringbuffer();
+    test_mpmc_ringbuffer();
+    test_frame_ring();
+    test_broadcast_ring();
+    test_ring_cpp();
+
+    // test heap management
+    test_heap();
+    test_arena();
 
     // test task management
     test_task();
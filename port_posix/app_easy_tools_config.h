@@ -0,0 +1,22 @@
+#ifndef _APP_EASY_TOOLS_CONFIG_H_
+#define _APP_EASY_TOOLS_CONFIG_H_
+
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// no need.
+#define __easy_disable_isr()
+#define __easy_enable_isr()
+
+// #define EASY_CONFIG_FUNCTION_TASK 0
+
+// #define EASY_CONFIG_DEBUG_LOG_LEVEL EASY_LOG_IMPL_LEVEL_INF
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_EASY_TOOLS_CONFIG_H_ */
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+EASY_ARENA_DEFINE(test_arena_static, 100);
+
+static void test_arena_work(void)
+{
+    SUITE_START("test_arena_work");
+
+    uint8_t buffer[0x100];
+    easy_arena_t arena;
+
+    // an unaligned buffer is aligned at init
+    easy_arena_init(&arena, buffer + 1, sizeof(buffer) - 1);
+    ASSERT(easy_arena_used_size(&arena) == 0);
+    ASSERT(easy_arena_reserve_size(&arena) <= sizeof(buffer) - 1);
+
+    uint8_t *a = easy_arena_alloc(&arena, 3);
+    uint8_t *b = easy_arena_alloc(&arena, 10);
+    ASSERT(a != NULL && b != NULL);
+    ASSERT(((uintptr_t)a % EASY_ARENA_ALIGN_SIZE) == 0);
+    ASSERT(((uintptr_t)b % EASY_ARENA_ALIGN_SIZE) == 0);
+    ASSERT(b >= a + 3);
+    ASSERT(a >= buffer + 1 && b + 10 <= buffer + sizeof(buffer));
+
+    // the arena is full, the failed allocation changes nothing
+    uint32_t used = easy_arena_used_size(&arena);
+    ASSERT(easy_arena_alloc(&arena, easy_arena_reserve_size(&arena) + 1) == NULL);
+    ASSERT(easy_arena_used_size(&arena) == used);
+    ASSERT(easy_arena_alloc(&arena, easy_arena_reserve_size(&arena)) != NULL);
+    ASSERT(easy_arena_reserve_size(&arena) == 0);
+    ASSERT(easy_arena_alloc(&arena, 1) == NULL);
+
+    // reset gives all back, peak is kept
+    easy_arena_reset(&arena);
+    ASSERT(easy_arena_used_size(&arena) == 0);
+    ASSERT(arena.peak_size == arena.total_size);
+    ASSERT(easy_arena_alloc(&arena, 3) == a);
+
+    EASY_ARENA_INIT(test_arena_static);
+    ASSERT(easy_arena_reserve_size(&test_arena_static) >= 100);
+    ASSERT(easy_arena_alloc(&test_arena_static, 100) != NULL);
+
+    SUITE_END();
+}
+
+static void test_arena_work_savepoint(void)
+{
+    SUITE_START("test_arena_work_savepoint");
+
+    uint8_t buffer[0x100];
+    easy_arena_t arena;
+
+    easy_arena_init(&arena, buffer, sizeof(buffer));
+
+    void *a = easy_arena_alloc(&arena, 16);
+    easy_arena_mark_t outer = easy_arena_save(&arena);
+    void *b = easy_arena_alloc(&arena, 16);
+    easy_arena_mark_t inner = easy_arena_save(&arena);
+    void *c = easy_arena_alloc(&arena, 16);
+    ASSERT(a != NULL && b != NULL && c != NULL);
+
+    // inner rollback frees c only
+    easy_arena_rollback(&arena, inner);
+    ASSERT(easy_arena_alloc(&arena, 16) == c);
+
+    // outer rollback frees b and c, a newer mark is ignored then
+    easy_arena_rollback(&arena, outer);
+    ASSERT(easy_arena_used_size(&arena) == outer);
+    easy_arena_rollback(&arena, inner);
+    ASSERT(easy_arena_used_size(&arena) == outer);
+    ASSERT(easy_arena_alloc(&arena, 16) == b);
+
+    SUITE_END();
+}
+
+#if EASY_CONFIG_FUNCTION_HEAP
+static void test_arena_work_msg(void)
+{
+    SUITE_START("test_arena_work_msg");
+
+    uint8_t buffer[0x100];
+    easy_arena_t arena;
+    struct easy_msg_allocator allocator = {easy_arena_hook_alloc, easy_arena_hook_free, &arena};
+    uint32_t remain_size = easy_heap_get_remain_size();
+    uint8_t param[4] = {1, 2, 3, 4};
+
+    easy_arena_init(&arena, buffer, sizeof(buffer));
+    easy_msg_set_allocator(&allocator);
+
+    // messages of one cycle come from the arena, the heap is not touched
+    struct easy_msg *msg0 = easy_msg_alloc(1, sizeof(param), param);
+    struct easy_msg *msg1 = easy_msg_alloc_len(2, 8);
+    ASSERT(msg0 != NULL && msg1 != NULL);
+    ASSERT((uint8_t *)msg0 >= buffer && (uint8_t *)msg1 < buffer + sizeof(buffer));
+    ASSERT(msg0->id == 1 && msg0->param[3] == 4);
+    ASSERT(msg1->id == 2 && msg1->param_len == 8);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    easy_msg_free(msg0);
+    easy_msg_free(msg1);
+    ASSERT(easy_arena_used_size(&arena) > 0);
+    easy_arena_reset(&arena);
+
+    // back to the default allocator
+    easy_msg_set_allocator(NULL);
+    msg0 = easy_msg_alloc_len(3, 4);
+    ASSERT(msg0 != NULL);
+    ASSERT((uint8_t *)msg0 < buffer || (uint8_t *)msg0 >= buffer + sizeof(buffer));
+    easy_msg_free(msg0);
+
+    SUITE_END();
+}
+#endif
+
+void test_arena(void)
+{
+    test_arena_work();
+    test_arena_work_savepoint();
+#if EASY_CONFIG_FUNCTION_HEAP
+    test_arena_work_msg();
+#endif
+}
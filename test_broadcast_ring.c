@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+#define TEST_BUFFER_SIZE 64
+
+static void test_broadcast_work(void)
+{
+    SUITE_START("test_broadcast_work");
+
+    EASY_BROADCAST_RING_DEFINE(test_ring, TEST_BUFFER_SIZE, sizeof(uint32_t));
+    easy_broadcast_consumer_t logger, processor, forwarder;
+    uint32_t data;
+    uint32_t seq = 0;
+    uint32_t logged = 0;
+    uint32_t forwarded = 0;
+
+    ASSERT(easy_broadcast_ring_init(&test_ring, TEST_BUFFER_SIZE - 1, sizeof(uint32_t), test_ring_data_storage) == -1);
+    ASSERT(EASY_BROADCAST_RING_INIT(test_ring, TEST_BUFFER_SIZE, sizeof(uint32_t)) == 0);
+
+    // no consumer, nothing gates the producer
+    for (uint32_t i = 0; i < TEST_BUFFER_SIZE * 2; i++)
+    {
+        ASSERT(easy_broadcast_ring_put(&test_ring, &seq) == 1);
+        seq++;
+    }
+    ASSERT(easy_broadcast_ring_size(&test_ring) == 0);
+
+    // the forwarder only sees what the processor released
+    easy_broadcast_ring_add_consumer(&test_ring, &logger, NULL);
+    easy_broadcast_ring_add_consumer(&test_ring, &processor, NULL);
+    easy_broadcast_ring_add_consumer(&test_ring, &forwarder, &processor);
+    ASSERT(easy_broadcast_ring_available(&test_ring, &logger) == 0);
+    ASSERT(easy_broadcast_ring_get(&test_ring, &logger, &data) == 0);
+    logged = forwarded = seq;
+
+    for (int test_cnt = 0; test_cnt < 0x100; test_cnt++)
+    {
+        // fill up to the slowest consumer
+        while (easy_broadcast_ring_put(&test_ring, &seq) == 1)
+        {
+            seq++;
+        }
+        ASSERT(easy_broadcast_ring_size(&test_ring) == TEST_BUFFER_SIZE);
+        ASSERT(easy_broadcast_ring_enqueue_get(&test_ring) == NULL);
+        ASSERT(easy_broadcast_ring_available(&test_ring, &forwarder) == 0);
+
+        // the processor marks the items in place
+        uint32_t available = easy_broadcast_ring_available(&test_ring, &processor);
+        ASSERT(available == seq - forwarded);
+        uint32_t n = EASY_MIN(available, (uint32_t)test_cnt % 7 + 1);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t *item = easy_broadcast_ring_peek(&test_ring, &processor, i);
+            ASSERT(item != NULL);
+            *item |= 0x80000000u;
+        }
+        ASSERT(easy_broadcast_ring_peek(&test_ring, &processor, available) == NULL);
+        easy_broadcast_ring_release(&test_ring, &processor, n);
+
+        // the forwarder sees the marks, the processor gates it
+        while (easy_broadcast_ring_get(&test_ring, &forwarder, &data) == 1)
+        {
+            ASSERT(data == (forwarded | 0x80000000u));
+            forwarded++;
+        }
+        ASSERT(easy_broadcast_ring_available(&test_ring, &forwarder) == 0);
+
+        // the logger is the slowest, it frees the slots
+        ASSERT(easy_broadcast_ring_enqueue_get(&test_ring) == NULL);
+        for (int i = 0; i < test_cnt % 5 + 1; i++)
+        {
+            ASSERT(easy_broadcast_ring_get(&test_ring, &logger, &data) == 1);
+            ASSERT((data & 0x7fffffffu) == logged);
+            logged++;
+        }
+        ASSERT(easy_broadcast_ring_size(&test_ring) == seq - EASY_MIN(logged, forwarded));
+    }
+
+    // without the logger the processor chain gates the producer
+    easy_broadcast_ring_remove_consumer(&test_ring, &logger);
+    ASSERT(easy_broadcast_ring_size(&test_ring) == seq - forwarded);
+
+    easy_broadcast_ring_release(&test_ring, &processor, easy_broadcast_ring_available(&test_ring, &processor));
+    easy_broadcast_ring_release(&test_ring, &forwarder, easy_broadcast_ring_available(&test_ring, &forwarder));
+    ASSERT(easy_broadcast_ring_size(&test_ring) == 0);
+    ASSERT(easy_broadcast_ring_put(&test_ring, &seq) == 1);
+
+    SUITE_END();
+}
+
+void test_broadcast_ring(void)
+{
+    test_broadcast_work();
+}
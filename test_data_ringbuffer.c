@@ -411,6 +411,154 @@ static void test_data_work_full_odd(void)
     SUITE_END();
 }
 
+static void test_data_work_overwrite(void)
+{
+    SUITE_START("test_data_work_overwrite");
+
+    EASY_DATA_RINGBUFFER_DEFINE(test_ringbuf, TEST_BUFFER_SIZE_ODD, sizeof(uint32_t));
+
+    uint32_t data;
+
+    // fill it and go round twice more, only the newest items are kept
+    for (uint32_t loop = 0; loop < TEST_BUFFER_SIZE_ODD * 3; loop++)
+    {
+        ASSERT(easy_data_ringbuffer_put_overwrite(&test_ringbuf, &loop) == 1);
+        ASSERT(easy_data_ringbuffer_size(&test_ringbuf) == EASY_MIN(loop + 1, TEST_BUFFER_SIZE_ODD));
+    }
+
+    ASSERT(easy_data_ringbuffer_is_full(&test_ringbuf) == 1);
+    ASSERT(easy_data_ringbuffer_put(&test_ringbuf, &data) == 0);
+    ASSERT(easy_data_ringbuffer_take_dropped(&test_ringbuf) == TEST_BUFFER_SIZE_ODD * 2);
+    ASSERT(easy_data_ringbuffer_take_dropped(&test_ringbuf) == 0);
+
+    for (uint32_t loop = 0; loop < TEST_BUFFER_SIZE_ODD / 2; loop++)
+    {
+        ASSERT(easy_data_ringbuffer_get_overwrite(&test_ringbuf, &data) == 1);
+        ASSERT(data == TEST_BUFFER_SIZE_ODD * 2 + loop);
+    }
+
+    // room left, nothing dropped
+    for (uint32_t loop = 0; loop < TEST_BUFFER_SIZE_ODD / 2; loop++)
+    {
+        ASSERT(easy_data_ringbuffer_put_overwrite(&test_ringbuf, &loop) == 1);
+    }
+    ASSERT(easy_data_ringbuffer_take_dropped(&test_ringbuf) == 0);
+    ASSERT(easy_data_ringbuffer_put_overwrite(&test_ringbuf, &data) == 1);
+    ASSERT(easy_data_ringbuffer_take_dropped(&test_ringbuf) == 1);
+
+    // the oldest one left is the next of the first round
+    ASSERT(easy_data_ringbuffer_get_overwrite(&test_ringbuf, &data) == 1);
+    ASSERT(data == TEST_BUFFER_SIZE_ODD * 2 + TEST_BUFFER_SIZE_ODD / 2 + 1);
+
+    while (easy_data_ringbuffer_get_overwrite(&test_ringbuf, &data))
+    {
+    }
+    ASSERT(easy_data_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    SUITE_END();
+}
+
+static void test_data_work_batch(void)
+{
+    SUITE_START("test_data_work_batch");
+
+    EASY_DATA_RINGBUFFER_DEFINE(test_ringbuf, TEST_BUFFER_SIZE_ODD, sizeof(uint32_t));
+
+    uint32_t data[TEST_BUFFER_SIZE_ODD * 2];
+    uint32_t seq = 0;
+    uint32_t expect = 0;
+    void *mem[2];
+    easy_data_ringbuffer_index_t count[2];
+
+    for (uint32_t test_cnt = 0; test_cnt < 0x1000; test_cnt++)
+    {
+        easy_data_ringbuffer_index_t n = (test_cnt * 37) % (TEST_BUFFER_SIZE_ODD + 10);
+        easy_data_ringbuffer_index_t reserve = easy_data_ringbuffer_reserve_size(&test_ringbuf);
+        easy_data_ringbuffer_index_t put;
+
+        // the batch is cut to the free room
+        if (test_cnt & 1)
+        {
+            for (uint32_t i = 0; i < n; i++)
+            {
+                data[i] = seq + i;
+            }
+            put = easy_data_ringbuffer_put_n(&test_ringbuf, data, n);
+        }
+        else
+        {
+            put = easy_data_ringbuffer_enqueue_get_n(&test_ringbuf, n, mem, count);
+            ASSERT(put == count[0] + count[1]);
+            ASSERT(count[1] == 0 || (uint8_t *)mem[0] + count[0] * sizeof(uint32_t) == (uint8_t *)test_ringbuf_data_storage + sizeof(test_ringbuf_data_storage));
+            for (uint32_t i = 0; i < put; i++)
+            {
+                uint32_t value = seq + i;
+                memcpy(i < count[0] ? (uint32_t *)mem[0] + i : (uint32_t *)mem[1] + (i - count[0]), &value, sizeof(value));
+            }
+            easy_data_ringbuffer_enqueue_n(&test_ringbuf, put);
+        }
+        ASSERT(put == EASY_MIN(n, reserve));
+        seq += put;
+        ASSERT(easy_data_ringbuffer_size(&test_ringbuf) == seq - expect);
+
+        // drain a different amount
+        n = (test_cnt * 53) % (TEST_BUFFER_SIZE_ODD + 10);
+        easy_data_ringbuffer_index_t got = easy_data_ringbuffer_get_n(&test_ringbuf, data, n);
+        ASSERT(got == EASY_MIN(n, seq - expect));
+        for (uint32_t i = 0; i < got; i++)
+        {
+            ASSERT(data[i] == expect + i);
+        }
+        expect += got;
+    }
+
+    ASSERT(easy_data_ringbuffer_get_n(&test_ringbuf, NULL, TEST_BUFFER_SIZE_ODD * 2) == seq - expect);
+    ASSERT(easy_data_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_data_ringbuffer_get_n(&test_ringbuf, data, 1) == 0);
+
+    SUITE_END();
+}
+
+#if EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT
+#define TEST_BUFFER_SIZE_LARGE 70000
+
+static void test_data_work_large(void)
+{
+    SUITE_START("test_data_work_large");
+
+    EASY_DATA_RINGBUFFER_DEFINE(test_ringbuf, TEST_BUFFER_SIZE_LARGE, sizeof(uint32_t));
+
+    uint32_t data;
+    void *mem;
+
+    // more items than a 16-bit index can count, and round the indices twice
+    for (uint32_t round = 0; round < 4; round++)
+    {
+        for (uint32_t loop = 0; loop < TEST_BUFFER_SIZE_LARGE; loop++)
+        {
+            easy_data_ringbuffer_index_t write_index = easy_data_ringbuffer_enqueue_get(&test_ringbuf, &mem);
+            ASSERT(mem != NULL);
+            data = round * TEST_BUFFER_SIZE_LARGE + loop;
+            memcpy(mem, &data, sizeof(data));
+            easy_data_ringbuffer_enqueue(&test_ringbuf, write_index);
+        }
+
+        ASSERT(easy_data_ringbuffer_size(&test_ringbuf) == TEST_BUFFER_SIZE_LARGE);
+        ASSERT(easy_data_ringbuffer_is_full(&test_ringbuf) == 1);
+        ASSERT(easy_data_ringbuffer_put(&test_ringbuf, &data) == 0);
+
+        for (uint32_t loop = 0; loop < TEST_BUFFER_SIZE_LARGE; loop++)
+        {
+            ASSERT(easy_data_ringbuffer_get(&test_ringbuf, &data) == 1);
+            ASSERT(data == round * TEST_BUFFER_SIZE_LARGE + loop);
+        }
+        ASSERT(easy_data_ringbuffer_is_empty(&test_ringbuf) == 1);
+    }
+
+    SUITE_END();
+}
+#endif
+
 void test_data_ringbuffer(void)
 {
     test_data_work();
@@ -420,4 +568,11 @@ void test_data_ringbuffer(void)
 
     test_data_work_odd();
     test_data_work_full_odd();
+
+    test_data_work_overwrite();
+    test_data_work_batch();
+
+#if EASY_CONFIG_DATA_RINGBUFFER_INDEX_32BIT
+    test_data_work_large();
+#endif
 }
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+#define TEST_BUFFER_SIZE 256
+
+static void test_frame_work(void)
+{
+    SUITE_START("test_frame_work");
+
+    easy_frame_ring_t test_ring;
+    easy_ringbuffer_span_t spans[2];
+    uint32_t test_buffer[TEST_BUFFER_SIZE / 4];
+    uint8_t rdata[TEST_BUFFER_SIZE];
+
+    easy_frame_ring_init(&test_ring, TEST_BUFFER_SIZE, (uint8_t *)test_buffer, 0);
+    ASSERT(easy_frame_ring_is_empty(&test_ring) == 1);
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == -1);
+    ASSERT(easy_frame_ring_get(&test_ring, rdata, sizeof(rdata)) == -1);
+
+    // nothing is visible before the commit
+    ASSERT(easy_frame_ring_reserve(&test_ring, 10, spans) == 0);
+    ASSERT(spans[0].len == 10 && spans[1].len == 0);
+    memcpy(spans[0].ptr, "0123456789", 10);
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == -1);
+    ASSERT(easy_frame_ring_commit(&test_ring, 7) == 0);
+    ASSERT(easy_frame_ring_commit(&test_ring, 7) == -1);
+    ASSERT(easy_frame_ring_size(&test_ring) == EASY_FRAME_RING_FRAME_SIZE(7));
+
+    ASSERT(easy_frame_ring_put(&test_ring, (const uint8_t *)"", 0) == 0);
+    ASSERT(easy_frame_ring_put(&test_ring, (const uint8_t *)"abc", 3) == 0);
+
+    // peek in place, then release
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == 7);
+    ASSERT(spans[0].len == 7 && spans[1].len == 0);
+    ASSERT(memcmp(spans[0].ptr, "0123456", 7) == 0);
+    easy_frame_ring_release(&test_ring);
+
+    ASSERT(easy_frame_ring_get(&test_ring, rdata, sizeof(rdata)) == 0);
+    ASSERT(easy_frame_ring_get(&test_ring, rdata, 2) == 3);
+    ASSERT(memcmp(rdata, "ab", 2) == 0);
+    ASSERT(easy_frame_ring_is_empty(&test_ring) == 1);
+
+    // too big
+    ASSERT(easy_frame_ring_reserve(&test_ring, TEST_BUFFER_SIZE, spans) == -1);
+    ASSERT(easy_frame_ring_reserve(&test_ring, TEST_BUFFER_SIZE - EASY_FRAME_RING_HEADER_SIZE, spans) == 0);
+
+    SUITE_END();
+}
+
+static void test_frame_work_wrap_size(int contiguous)
+{
+    easy_frame_ring_t test_ring;
+    easy_ringbuffer_span_t spans[2];
+    uint32_t test_buffer[TEST_BUFFER_SIZE / 4];
+    uint8_t data[TEST_BUFFER_SIZE];
+    uint8_t rdata[TEST_BUFFER_SIZE];
+    uint8_t wseq = 0;
+    uint8_t rseq = 0;
+    int frames = 0;
+
+    easy_frame_ring_init(&test_ring, TEST_BUFFER_SIZE, (uint8_t *)test_buffer, contiguous);
+
+    // frames of every size, the reader lags so frames wrap at every position
+    for (uint32_t i = 0; i < 0x4000; i++)
+    {
+        uint32_t len = (i * 7) % 97;
+
+        for (uint32_t j = 0; j < len; j++)
+        {
+            data[j] = wseq + j;
+        }
+
+        if (easy_frame_ring_put(&test_ring, data, len) == 0)
+        {
+            wseq++;
+            frames++;
+        }
+
+        while (frames > 0 && (frames > 2 || i % 3 == 0))
+        {
+            int32_t frame_len = easy_frame_ring_peek(&test_ring, spans);
+
+            ASSERT(frame_len >= 0);
+            ASSERT(spans[0].len + spans[1].len == (uint32_t)frame_len);
+            if (contiguous)
+            {
+                ASSERT(spans[1].len == 0);
+            }
+
+            ASSERT(easy_frame_ring_get(&test_ring, rdata, sizeof(rdata)) == frame_len);
+            for (int32_t j = 0; j < frame_len; j++)
+            {
+                ASSERT(rdata[j] == (uint8_t)(rseq + j));
+            }
+            rseq++;
+            frames--;
+        }
+    }
+
+    while (easy_frame_ring_get(&test_ring, rdata, sizeof(rdata)) >= 0)
+    {
+        frames--;
+    }
+    ASSERT(frames == 0);
+    ASSERT(easy_frame_ring_size(&test_ring) == 0);
+}
+
+static void test_frame_work_wrap(void)
+{
+    SUITE_START("test_frame_work_wrap");
+
+    test_frame_work_wrap_size(0);
+
+    SUITE_END();
+}
+
+static void test_frame_work_contiguous(void)
+{
+    SUITE_START("test_frame_work_contiguous");
+
+    EASY_FRAME_RING_DEFINE(test_ring, TEST_BUFFER_SIZE, 1);
+    easy_ringbuffer_span_t spans[2];
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+
+    // 200 bytes used, 56 left at the end
+    ASSERT(easy_frame_ring_put(&test_ring, data, 196) == 0);
+    ASSERT(easy_frame_ring_size(&test_ring) == 200);
+    easy_frame_ring_release(&test_ring);
+
+    // does not fit before the end, so it starts at the beginning
+    ASSERT(easy_frame_ring_reserve(&test_ring, 60, spans) == 0);
+    ASSERT(spans[0].ptr == (uint8_t *)test_ring_data_storage + EASY_FRAME_RING_HEADER_SIZE);
+    ASSERT(spans[0].len == 60 && spans[1].len == 0);
+    ASSERT(easy_frame_ring_commit(&test_ring, 60) == 0);
+    ASSERT(easy_frame_ring_size(&test_ring) == 56 + 64);
+
+    // the padding is skipped
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == 60);
+    ASSERT(spans[0].ptr == (uint8_t *)test_ring_data_storage + EASY_FRAME_RING_HEADER_SIZE);
+    ASSERT(easy_frame_ring_size(&test_ring) == 64);
+    easy_frame_ring_release(&test_ring);
+    ASSERT(easy_frame_ring_is_empty(&test_ring) == 1);
+
+    // empty at 64, neither 192 bytes at the end nor 64 at the beginning hold
+    // it: the end is padded and the frame fits once the reader skipped it
+    ASSERT(easy_frame_ring_reserve(&test_ring, 200, spans) == -1);
+    ASSERT(easy_frame_ring_size(&test_ring) == 192);
+    ASSERT(easy_frame_ring_reserve(&test_ring, 200, spans) == -1);
+    ASSERT(easy_frame_ring_size(&test_ring) == 192);
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == -1);
+    ASSERT(easy_frame_ring_is_empty(&test_ring) == 1);
+    for (int i = 0; i < 200; i++)
+    {
+        data[i] = (uint8_t)i;
+    }
+    ASSERT(easy_frame_ring_put(&test_ring, data, 200) == 0);
+    ASSERT(easy_frame_ring_peek(&test_ring, spans) == 200);
+    ASSERT(spans[0].ptr == (uint8_t *)test_ring_data_storage + EASY_FRAME_RING_HEADER_SIZE);
+    ASSERT(spans[0].len == 200 && memcmp(spans[0].ptr, data, 200) == 0);
+    easy_frame_ring_release(&test_ring);
+
+    // the largest frame gets through from any position
+    ASSERT(easy_frame_ring_put(&test_ring, data, 4) == 0);
+    easy_frame_ring_release(&test_ring);
+    ASSERT(easy_frame_ring_put(&test_ring, data, TEST_BUFFER_SIZE - EASY_FRAME_RING_HEADER_SIZE) == -1);
+    easy_frame_ring_release(&test_ring);
+    ASSERT(easy_frame_ring_put(&test_ring, data, TEST_BUFFER_SIZE - EASY_FRAME_RING_HEADER_SIZE) == 0);
+    ASSERT(easy_frame_ring_get(&test_ring, data, sizeof(data)) == TEST_BUFFER_SIZE - EASY_FRAME_RING_HEADER_SIZE);
+    ASSERT(easy_frame_ring_is_empty(&test_ring) == 1);
+
+    test_frame_work_wrap_size(1);
+
+    SUITE_END();
+}
+
+void test_frame_ring(void)
+{
+    test_frame_work();
+    test_frame_work_wrap();
+    test_frame_work_contiguous();
+}
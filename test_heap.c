@@ -0,0 +1,883 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+#if EASY_CONFIG_FUNCTION_HEAP
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+#define TEST_ALLOC_CNT 8
+
+static void test_heap_work(void)
+{
+    SUITE_START("test_heap_work");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+    uint8_t *ptr[TEST_ALLOC_CNT];
+
+    ASSERT(easy_heap_check_empty());
+
+    for (int i = 0; i < TEST_ALLOC_CNT; i++)
+    {
+        uint32_t len = 8 + i * 13;
+        ptr[i] = easy_heap_malloc(len);
+        ASSERT(ptr[i] != NULL);
+        memset(ptr[i], i, len);
+    }
+    ASSERT(easy_heap_get_remain_size() < remain_size);
+    ASSERT(!easy_heap_check_empty());
+
+    // check no block overlap with others
+    for (int i = 0; i < TEST_ALLOC_CNT; i++)
+    {
+        uint32_t len = 8 + i * 13;
+        for (uint32_t j = 0; j < len; j++)
+        {
+            ASSERT(ptr[i][j] == (uint8_t)i);
+        }
+    }
+
+    // free the odd blocks first, then the even blocks
+    for (int i = 1; i < TEST_ALLOC_CNT; i += 2)
+    {
+        easy_heap_free(ptr[i]);
+    }
+    for (int i = 0; i < TEST_ALLOC_CNT; i += 2)
+    {
+        easy_heap_free(ptr[i]);
+    }
+
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+
+static void test_heap_work_full(void)
+{
+    SUITE_START("test_heap_work_full");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+    void *ptr[0x100];
+    int cnt = 0;
+
+    // exhaust the heap with small blocks
+    while (cnt < EASY_ARRAY_SIZE(ptr))
+    {
+        ptr[cnt] = easy_heap_malloc(16);
+        if (ptr[cnt] == NULL)
+        {
+            break;
+        }
+        cnt++;
+    }
+    ASSERT(cnt > 0);
+    ASSERT(cnt < EASY_ARRAY_SIZE(ptr));
+    ASSERT(easy_heap_malloc(remain_size) == NULL);
+
+    // free in reverse order, all blocks must be merged again
+    for (int i = cnt - 1; i >= 0; i--)
+    {
+        easy_heap_free(ptr[i]);
+    }
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+    ASSERT(easy_heap_check_empty());
+
+    // the merged block can be allocated as a whole
+    ptr[0] = easy_heap_malloc(easy_heap_instance_get_remain_size(easy_heap_get_default()) / 2);
+    ASSERT(ptr[0] != NULL);
+    easy_heap_free(ptr[0]);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+
+static void test_heap_work_merge(void)
+{
+    SUITE_START("test_heap_work_merge");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+    // with thread cache, the blocks must fit in the default heap instance
+    uint32_t len = easy_heap_instance_get_remain_size(easy_heap_get_default()) / 4;
+
+    void *a = easy_heap_malloc(len);
+    void *b = easy_heap_malloc(len);
+    void *c = easy_heap_malloc(len);
+    ASSERT(a != NULL && b != NULL && c != NULL);
+
+    // free middle block first, then both neighbours merge into it
+    easy_heap_free(b);
+    easy_heap_free(a);
+    easy_heap_free(c);
+    ASSERT(easy_heap_check_empty());
+
+    void *big = easy_heap_malloc(len * 3);
+    ASSERT(big != NULL);
+    easy_heap_free(big);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    SUITE_END();
+}
+
+static void test_heap_work_invalid(void)
+{
+    SUITE_START("test_heap_work_invalid");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+
+    easy_heap_free(NULL);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    ASSERT(easy_heap_malloc(remain_size + 1) == NULL);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    // double free is ignored
+    void *ptr = easy_heap_malloc(32);
+    ASSERT(ptr != NULL);
+    easy_heap_free(ptr);
+    easy_heap_free(ptr);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+
+static void test_heap_work_instance(void)
+{
+    SUITE_START("test_heap_work_instance");
+
+    static uint32_t heap_buf_a[0x100];
+    static uint32_t heap_buf_b[0x80];
+    easy_heap_t heap_a, heap_b;
+
+    easy_heap_instance_init(&heap_a, heap_buf_a, sizeof(heap_buf_a));
+    easy_heap_instance_init(&heap_b, heap_buf_b, sizeof(heap_buf_b));
+
+    uint32_t remain_a = easy_heap_instance_get_remain_size(&heap_a);
+    uint32_t remain_b = easy_heap_instance_get_remain_size(&heap_b);
+    uint32_t remain_default = easy_heap_get_remain_size();
+    ASSERT(remain_a > remain_b);
+    ASSERT(easy_heap_instance_check_empty(&heap_a));
+    ASSERT(easy_heap_instance_check_empty(&heap_b));
+    ASSERT(easy_heap_get_default() != &heap_a);
+
+    // every instance allocates from its own memory
+    uint8_t *a = easy_heap_instance_malloc(&heap_a, 64);
+    uint8_t *b = easy_heap_instance_malloc(&heap_b, 64);
+    ASSERT(a >= (uint8_t *)heap_buf_a && a + 64 <= (uint8_t *)heap_buf_a + sizeof(heap_buf_a));
+    ASSERT(b >= (uint8_t *)heap_buf_b && b + 64 <= (uint8_t *)heap_buf_b + sizeof(heap_buf_b));
+    ASSERT(easy_heap_instance_get_remain_size(&heap_a) < remain_a);
+    ASSERT(easy_heap_instance_get_remain_size(&heap_b) < remain_b);
+    ASSERT(easy_heap_get_remain_size() == remain_default);
+
+    // exhaust one instance, the other is not affected
+    ASSERT(easy_heap_instance_malloc(&heap_b, sizeof(heap_buf_b)) == NULL);
+    ASSERT(easy_heap_instance_malloc(&heap_a, sizeof(heap_buf_b)) != NULL);
+
+    easy_heap_instance_free(&heap_b, b);
+    ASSERT(easy_heap_instance_check_empty(&heap_b));
+    ASSERT(!easy_heap_instance_check_empty(&heap_a));
+
+    // re-init drops all the blocks
+    easy_heap_instance_init(&heap_a, heap_buf_a, sizeof(heap_buf_a));
+    ASSERT(easy_heap_instance_check_empty(&heap_a));
+    ASSERT(easy_heap_instance_get_remain_size(&heap_a) == remain_a);
+
+    SUITE_END();
+}
+
+static void test_heap_work_realloc(void)
+{
+    SUITE_START("test_heap_work_realloc");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+    uint8_t *ptr = easy_heap_realloc(NULL, 32);
+    ASSERT(ptr != NULL);
+    ASSERT(easy_heap_get_usable_size(ptr) >= 32);
+    for (int i = 0; i < 32; i++)
+    {
+        ptr[i] = (uint8_t)i;
+    }
+
+    // nothing behind the block is in use, so it grows in place
+    uint8_t *grown = easy_heap_realloc(ptr, 256);
+    ASSERT(grown == ptr);
+    ASSERT(easy_heap_get_usable_size(grown) >= 256);
+
+    // a used block behind forces a move, the data is kept
+    uint8_t *fence = easy_heap_malloc(16);
+    ASSERT(fence != NULL);
+    grown = easy_heap_realloc(ptr, 512);
+    ASSERT(grown != NULL && grown != ptr);
+    for (int i = 0; i < 32; i++)
+    {
+        ASSERT(grown[i] == (uint8_t)i);
+    }
+
+    // shrink stays in place
+    ptr = easy_heap_realloc(grown, 24);
+    ASSERT(ptr == grown);
+    ASSERT(ptr[23] == 23);
+
+    ASSERT(easy_heap_realloc(ptr, 0) == NULL);
+    easy_heap_free(fence);
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    // calloc zeroes the memory and rejects overflow
+    uint32_t *zero = easy_heap_calloc(16, sizeof(uint32_t));
+    ASSERT(zero != NULL);
+    for (int i = 0; i < 16; i++)
+    {
+        ASSERT(zero[i] == 0);
+    }
+    easy_heap_free(zero);
+    ASSERT(easy_heap_calloc(0x10000, 0x10000) == NULL);
+
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+
+static void test_heap_work_aligned(void)
+{
+    SUITE_START("test_heap_work_aligned");
+
+    uint32_t remain_size = easy_heap_get_remain_size();
+    void *ptr[6];
+    int cnt = 0;
+
+    ASSERT(easy_heap_aligned_alloc(24, 16) == NULL);
+
+    for (uint32_t align = 16; align <= 64; align <<= 1)
+    {
+        // a small block in front shifts the next allocation off the boundary
+        ptr[cnt] = easy_heap_malloc(4);
+        ASSERT(ptr[cnt] != NULL);
+        cnt++;
+
+        ptr[cnt] = easy_heap_aligned_alloc(align, 40);
+        ASSERT(ptr[cnt] != NULL);
+        ASSERT(((uintptr_t)ptr[cnt] & (align - 1)) == 0);
+        ASSERT(easy_heap_get_usable_size(ptr[cnt]) >= 40);
+        memset(ptr[cnt], 0x5a, 40);
+        cnt++;
+    }
+
+    for (int i = 0; i < cnt; i++)
+    {
+        easy_heap_free(ptr[i]);
+    }
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+
+static int test_heap_walk_count(void *block, easy_heap_size_t size, int used, void *arg)
+{
+    uint32_t *cnt = arg;
+
+    EASY_UNUSED(block);
+    EASY_UNUSED(size);
+    cnt[used ? 1 : 0]++;
+    return 0;
+}
+
+static void test_heap_work_stats(void)
+{
+    SUITE_START("test_heap_work_stats");
+
+    static uint32_t heap_buf[0x100];
+    easy_heap_t heap;
+    easy_heap_stats_t stats;
+    uint32_t cnt[2] = {0, 0};
+    void *ptr[6];
+
+    easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+    easy_heap_instance_get_stats(&heap, &stats);
+    // the bump region of the bounded walk mode is a free block of its own
+    uint32_t free_blocks = stats.xNumberOfFreeBlocks;
+    uint32_t fragmentation = stats.xFragmentation;
+    ASSERT(free_blocks == ((EASY_CONFIG_HEAP_WALK_LIMIT && !EASY_CONFIG_HEAP_TLSF) ? 2 : 1));
+    ASSERT(stats.xNumberOfUsedBlocks == 0);
+    ASSERT(free_blocks > 1 || stats.xFragmentation == 0);
+    ASSERT(free_blocks > 1 || stats.xSizeOfLargestFreeBlockInBytes == stats.xAvailableHeapSpaceInBytes);
+
+    for (int i = 0; i < 6; i++)
+    {
+        ptr[i] = easy_heap_instance_malloc(&heap, 40);
+        ASSERT(ptr[i] != NULL);
+    }
+
+    // free every other block, the holes can not be merged
+    for (int i = 0; i < 6; i += 2)
+    {
+        easy_heap_instance_free(&heap, ptr[i]);
+    }
+    easy_heap_instance_get_stats(&heap, &stats);
+    ASSERT(stats.xNumberOfFreeBlocks == free_blocks + 3);
+    ASSERT(stats.xNumberOfUsedBlocks == 3);
+    ASSERT(stats.xSizeOfSmallestFreeBlockInBytes >= 40);
+    ASSERT(stats.xSizeOfLargestFreeBlockInBytes < stats.xAvailableHeapSpaceInBytes);
+    ASSERT(stats.xFragmentation > fragmentation && stats.xFragmentation < 1000);
+    ASSERT(stats.xNumberOfSuccessfulAllocations == 6);
+    ASSERT(stats.xNumberOfSuccessfulFrees == 3);
+#if EASY_CONFIG_HEAP_STATS
+    ASSERT(stats.xAllocSizeHistogram[easy_heap_stats_bucket(40)] == 6);
+#endif
+
+    easy_heap_instance_walk(&heap, test_heap_walk_count, cnt);
+    ASSERT(cnt[0] == free_blocks + 3 && cnt[1] == 3);
+
+    for (int i = 1; i < 6; i += 2)
+    {
+        easy_heap_instance_free(&heap, ptr[i]);
+    }
+    easy_heap_instance_get_stats(&heap, &stats);
+    ASSERT(stats.xNumberOfFreeBlocks == free_blocks);
+    ASSERT(stats.xFragmentation == fragmentation);
+
+    ASSERT(easy_heap_stats_bucket(0) == 0);
+    ASSERT(easy_heap_stats_bucket(1) == 0);
+    ASSERT(easy_heap_stats_bucket(40) == 5);
+    ASSERT(easy_heap_stats_bucket(0xffffffff) == EASY_HEAP_STATS_BUCKET_COUNT - 1);
+
+    SUITE_END();
+}
+
+static void test_heap_work_bounded(void)
+{
+    SUITE_START("test_heap_work_bounded");
+
+    static uint32_t heap_buf[0x200];
+    easy_heap_t heap;
+    void *ptr[16];
+
+    easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+    easy_heap_size_t remain = easy_heap_instance_get_remain_size(&heap);
+
+    // leave a list of small holes in front of the large free space
+    for (int i = 0; i < 16; i++)
+    {
+        ptr[i] = easy_heap_instance_malloc(&heap, 16);
+        ASSERT(ptr[i] != NULL);
+    }
+    for (int i = 0; i < 16; i += 2)
+    {
+        easy_heap_instance_free(&heap, ptr[i]);
+    }
+
+    uint8_t *large = easy_heap_instance_malloc(&heap, 256);
+    ASSERT(large != NULL);
+#if EASY_CONFIG_HEAP_WALK_LIMIT && !EASY_CONFIG_HEAP_TLSF
+    // the walk gave up in the holes, the block is carved from the bump region
+    ASSERT(large >= (uint8_t *)heap_buf + sizeof(heap_buf) / 2);
+#endif
+
+    easy_heap_instance_free(&heap, large);
+    for (int i = 1; i < 16; i += 2)
+    {
+        easy_heap_instance_free(&heap, ptr[i]);
+    }
+    ASSERT(easy_heap_instance_check_empty(&heap));
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+
+    ASSERT(sizeof(easy_heap_size_t) == (EASY_CONFIG_HEAP_SIZE_64BIT ? sizeof(size_t) : sizeof(uint32_t)));
+
+    SUITE_END();
+}
+
+static void test_heap_work_bump(void)
+{
+    SUITE_START("test_heap_work_bump");
+
+    static uint32_t heap_buf[0x4000];
+    static void *large[64];
+    easy_heap_t heap;
+    void *holes[64];
+    int cnt = 0;
+
+    easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+    easy_heap_size_t remain = easy_heap_instance_get_remain_size(&heap);
+
+    // more small holes in front of the free space than the walk limit
+    for (int i = 0; i < 64; i++)
+    {
+        holes[i] = easy_heap_instance_malloc(&heap, 16);
+        ASSERT(holes[i] != NULL);
+    }
+    for (int i = 0; i < 64; i += 2)
+    {
+        easy_heap_instance_free(&heap, holes[i]);
+    }
+
+    // many more rounds than the bump region holds, a freed block goes back to it
+    uint8_t *first = easy_heap_instance_malloc(&heap, 256);
+    ASSERT(first != NULL);
+    easy_heap_instance_free(&heap, first);
+    for (int i = 0; i < 2000; i++)
+    {
+        uint8_t *ptr = easy_heap_instance_malloc(&heap, 256);
+        ASSERT(ptr != NULL);
+#if EASY_CONFIG_HEAP_WALK_LIMIT && !EASY_CONFIG_HEAP_TLSF
+        ASSERT(ptr == first);
+#endif
+        easy_heap_instance_free(&heap, ptr);
+    }
+
+    // use the bump region up
+    while (cnt < EASY_ARRAY_SIZE(large) && (large[cnt] = easy_heap_instance_malloc(&heap, 1024)) != NULL)
+    {
+        cnt++;
+    }
+#if EASY_CONFIG_HEAP_WALK_LIMIT && !EASY_CONFIG_HEAP_WALK_FALLBACK && !EASY_CONFIG_HEAP_TLSF
+    // the free space behind the holes is out of reach, but no malloc walks
+    // more than the limit, not even the failed ones
+    ASSERT(cnt > 0 && cnt < EASY_ARRAY_SIZE(large));
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT(easy_heap_instance_malloc(&heap, 1024) == NULL);
+    }
+#if EASY_CONFIG_HEAP_STATS
+    easy_heap_stats_t stats;
+    easy_heap_instance_get_stats(&heap, &stats);
+    for (int i = easy_heap_stats_bucket(EASY_CONFIG_HEAP_WALK_LIMIT) + 1; i < EASY_HEAP_STATS_BUCKET_COUNT; i++)
+    {
+        ASSERT(stats.xMallocWalkHistogram[i] == 0);
+    }
+#endif
+#else
+    // the rest of the free space is found
+    ASSERT(cnt > 32 && cnt < EASY_ARRAY_SIZE(large));
+#if !EASY_CONFIG_HEAP_TLSF
+    easy_heap_instance_free(&heap, large[cnt / 2]);
+    large[cnt / 2] = easy_heap_instance_malloc(&heap, 1024);
+    ASSERT(large[cnt / 2] != NULL);
+#endif
+#endif
+#if !EASY_CONFIG_HEAP_TLSF
+    // the last block goes back to the bump region or the last free block
+    easy_heap_instance_free(&heap, large[cnt - 1]);
+    large[cnt - 1] = easy_heap_instance_malloc(&heap, 1024);
+    ASSERT(large[cnt - 1] != NULL);
+#endif
+
+    for (int i = 0; i < cnt; i++)
+    {
+        easy_heap_instance_free(&heap, large[i]);
+    }
+    for (int i = 1; i < 64; i += 2)
+    {
+        easy_heap_instance_free(&heap, holes[i]);
+    }
+    ASSERT(easy_heap_instance_check_empty(&heap));
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+
+    SUITE_END();
+}
+
+#if !EASY_CONFIG_HEAP_TLSF
+static void test_heap_work_policy(void)
+{
+    SUITE_START("test_heap_work_policy");
+
+    static uint32_t heap_buf[0x200];
+    easy_heap_t heap;
+    void *a, *c, *g1, *g2, *p;
+
+    // holes of 64 and 16 bytes in front of the large free space
+    for (int policy = EASY_HEAP_POLICY_FIRST_FIT; policy <= EASY_HEAP_POLICY_BEST_FIT; policy++)
+    {
+        easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+        easy_heap_instance_set_policy(&heap, (easy_heap_policy_t)policy);
+        a = easy_heap_instance_malloc(&heap, 64);
+        g1 = easy_heap_instance_malloc(&heap, 16);
+        c = easy_heap_instance_malloc(&heap, 16);
+        g2 = easy_heap_instance_malloc(&heap, 16);
+        ASSERT(a != NULL && g1 != NULL && c != NULL && g2 != NULL);
+        easy_heap_instance_free(&heap, a);
+        easy_heap_instance_free(&heap, c);
+
+        p = easy_heap_instance_malloc(&heap, 16);
+        ASSERT(p == ((policy == EASY_HEAP_POLICY_BEST_FIT) ? c : a));
+
+        easy_heap_instance_free(&heap, p);
+        easy_heap_instance_free(&heap, g1);
+        easy_heap_instance_free(&heap, g2);
+        ASSERT(easy_heap_instance_check_empty(&heap));
+    }
+
+    // next-fit goes on after the last allocation
+    for (int policy = EASY_HEAP_POLICY_FIRST_FIT; policy <= EASY_HEAP_POLICY_NEXT_FIT; policy++)
+    {
+        easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+        easy_heap_instance_set_policy(&heap, (easy_heap_policy_t)policy);
+        a = easy_heap_instance_malloc(&heap, 16);
+        g1 = easy_heap_instance_malloc(&heap, 16);
+        c = easy_heap_instance_malloc(&heap, 64);
+        g2 = easy_heap_instance_malloc(&heap, 16);
+        easy_heap_instance_free(&heap, a);
+        easy_heap_instance_free(&heap, c);
+
+        ASSERT(easy_heap_instance_malloc(&heap, 64) == c);
+        p = easy_heap_instance_malloc(&heap, 16);
+        ASSERT((p == a) == (policy == EASY_HEAP_POLICY_FIRST_FIT));
+
+        easy_heap_instance_free(&heap, p);
+        easy_heap_instance_free(&heap, c);
+        easy_heap_instance_free(&heap, g1);
+        easy_heap_instance_free(&heap, g2);
+        ASSERT(easy_heap_instance_check_empty(&heap));
+
+        // the rover survives merges, the heap is one block again
+        p = easy_heap_instance_malloc(&heap, easy_heap_instance_get_remain_size(&heap) / 2);
+        ASSERT(p != NULL);
+        easy_heap_instance_free(&heap, p);
+    }
+
+    SUITE_END();
+}
+#endif
+
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+static void test_heap_work_deferred(void)
+{
+    SUITE_START("test_heap_work_deferred");
+
+    static uint32_t heap_buf[0x200];
+    easy_heap_t heap;
+    easy_heap_stats_t stats;
+    void *ptr[16];
+
+    easy_heap_instance_init(&heap, heap_buf, sizeof(heap_buf));
+    easy_heap_size_t remain = easy_heap_instance_get_remain_size(&heap);
+    easy_heap_instance_get_stats(&heap, &stats);
+    uint32_t free_blocks = stats.xNumberOfFreeBlocks;
+
+    for (int i = 0; i < 16; i++)
+    {
+        ptr[i] = easy_heap_instance_malloc(&heap, 16 + i);
+        ASSERT(ptr[i] != NULL);
+    }
+
+    // pending blocks still count as used until collected
+    for (int i = 0; i < 16; i++)
+    {
+        easy_heap_instance_free_deferred(&heap, ptr[(i * 7) % 16]);
+    }
+    easy_heap_instance_free_deferred(&heap, NULL);
+    ASSERT(!easy_heap_instance_check_empty(&heap));
+    ASSERT(easy_heap_instance_get_remain_size(&heap) < remain);
+
+    // the batch is merged back into one block
+    easy_heap_instance_collect(&heap);
+    ASSERT(easy_heap_instance_check_empty(&heap));
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+    easy_heap_instance_get_stats(&heap, &stats);
+    ASSERT(stats.xNumberOfFreeBlocks == free_blocks);
+    ASSERT(stats.xNumberOfSuccessfulFrees == 16);
+
+    // the next malloc collects by itself
+    ptr[0] = easy_heap_instance_malloc(&heap, 32);
+    ptr[1] = easy_heap_instance_malloc(&heap, 32);
+    easy_heap_instance_free_deferred(&heap, ptr[1]);
+    easy_heap_instance_free_deferred(&heap, ptr[0]);
+    ptr[2] = easy_heap_instance_malloc(&heap, 64);
+    ASSERT(ptr[2] == ptr[0]);
+    easy_heap_instance_free_deferred(&heap, ptr[2]);
+    easy_heap_instance_collect(&heap);
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+
+    // a double free is only pushed once, a pending block can not be freed
+    ptr[0] = easy_heap_instance_malloc(&heap, 32);
+    ptr[1] = easy_heap_instance_malloc(&heap, 32);
+    easy_heap_instance_get_stats(&heap, &stats);
+    uint32_t frees = stats.xNumberOfSuccessfulFrees;
+    easy_heap_instance_free_deferred(&heap, ptr[0]);
+    easy_heap_instance_free_deferred(&heap, ptr[0]);
+    easy_heap_instance_free_deferred(&heap, ptr[1]);
+    easy_heap_instance_free_deferred(&heap, ptr[0]);
+    easy_heap_instance_free(&heap, ptr[1]);
+    ASSERT(easy_heap_get_usable_size(ptr[0]) == 0);
+    ASSERT(easy_heap_instance_get_remain_size(&heap) < remain);
+    easy_heap_instance_collect(&heap);
+    ASSERT(easy_heap_instance_check_empty(&heap));
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+    easy_heap_instance_get_stats(&heap, &stats);
+    ASSERT(stats.xNumberOfSuccessfulFrees == frees + 2);
+    easy_heap_instance_free_deferred(&heap, ptr[0]);
+    easy_heap_instance_collect(&heap);
+    ASSERT(easy_heap_instance_get_remain_size(&heap) == remain);
+
+    // the default heap defers easy_heap_free
+    remain = easy_heap_get_remain_size();
+    ptr[0] = easy_heap_malloc(32);
+    ASSERT(ptr[0] != NULL);
+    easy_heap_free(ptr[0]);
+    easy_heap_collect();
+    ASSERT(easy_heap_check_empty());
+    ASSERT(easy_heap_get_remain_size() == remain);
+
+    SUITE_END();
+}
+#endif
+
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+#include <pthread.h>
+
+#define TEST_THREAD_CNT    4
+#define TEST_THREAD_ROUNDS 20000
+#define TEST_THREAD_BLOCKS 16
+
+EASY_MPMC_RINGBUFFER_DEFINE(test_heap_handoff, 64, sizeof(void *));
+static void *test_heap_thread_blocks[TEST_THREAD_BLOCKS];
+
+static void *test_heap_thread_alloc(void *arg)
+{
+    EASY_UNUSED(arg);
+
+    for (int i = 0; i < TEST_THREAD_BLOCKS; i++)
+    {
+        test_heap_thread_blocks[i] = easy_heap_malloc(16 + i * 8);
+    }
+
+    // the cache is given back when the thread exits, with the blocks in use
+    return NULL;
+}
+
+static void *test_heap_thread_handoff(void *arg)
+{
+    uint32_t seed = (uint32_t)(uintptr_t)arg;
+    uintptr_t errors = 0;
+    uint8_t *ptr, *other;
+
+    for (int i = 0; i < TEST_THREAD_ROUNDS; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        ptr = easy_heap_malloc(8 + (seed >> 16) % 120);
+        if (ptr == NULL)
+        {
+            errors++;
+            continue;
+        }
+        memset(ptr, (uint8_t)(uintptr_t)ptr, 8);
+
+        // any thread frees it, mostly not the one which allocated it
+        while (easy_mpmc_ringbuffer_put(&test_heap_handoff, &ptr) == 0)
+        {
+            if (easy_mpmc_ringbuffer_get(&test_heap_handoff, &other))
+            {
+                errors += other[7] != (uint8_t)(uintptr_t)other;
+                easy_heap_free(other);
+            }
+        }
+        if ((seed >> 8) & 1 && easy_mpmc_ringbuffer_get(&test_heap_handoff, &other))
+        {
+            errors += other[7] != (uint8_t)(uintptr_t)other;
+            easy_heap_free(other);
+        }
+    }
+
+    return (void *)errors;
+}
+
+static void test_heap_work_thread_cache(void)
+{
+    SUITE_START("test_heap_work_thread_cache");
+
+    static uint32_t heap_buf[(2 * EASY_CONFIG_HEAP_THREAD_CACHE_SIZE * (TEST_THREAD_CNT + 1) + 0x1000) / sizeof(uint32_t)];
+    struct easy_heap_ptr port_heap = {0};
+    pthread_t threads[TEST_THREAD_CNT];
+    easy_heap_stats_t stats;
+    uint8_t *ptr;
+    void *ret;
+
+    // the port heap is too small for the caches, use a heap with room for
+    // every thread
+    ASSERT(easy_heap_check_empty());
+    easy_heap_thread_cache_release();
+    easy_heap_init(heap_buf, sizeof(heap_buf));
+    easy_heap_size_t remain = easy_heap_get_remain_size();
+    easy_heap_get_stats(&stats);
+    uint32_t shared_allocs = stats.xNumberOfSuccessfulAllocations;
+
+    // blocks of an exited thread are freed into a cache nobody owns
+    ASSERT(pthread_create(&threads[0], NULL, test_heap_thread_alloc, NULL) == 0);
+    pthread_join(threads[0], NULL);
+    for (int i = 0; i < TEST_THREAD_BLOCKS; i++)
+    {
+        ASSERT(test_heap_thread_blocks[i] != NULL);
+    }
+    ASSERT(!easy_heap_check_empty());
+    for (int i = 0; i < TEST_THREAD_BLOCKS; i++)
+    {
+        easy_heap_free(test_heap_thread_blocks[i]);
+    }
+    ASSERT(easy_heap_check_empty());
+    ASSERT(easy_heap_get_remain_size() == remain);
+
+    // the threads hand their blocks to each other, some are left to be freed
+    // after the threads exited
+    ASSERT(EASY_MPMC_RINGBUFFER_INIT(test_heap_handoff, 64, sizeof(void *)) == 0);
+    for (uintptr_t i = 0; i < TEST_THREAD_CNT; i++)
+    {
+        ASSERT(pthread_create(&threads[i], NULL, test_heap_thread_handoff, (void *)(i + 1)) == 0);
+    }
+    for (int i = 0; i < TEST_THREAD_CNT; i++)
+    {
+        pthread_join(threads[i], &ret);
+        ASSERT(ret == NULL);
+    }
+    ASSERT(!easy_heap_check_empty());
+    while (easy_mpmc_ringbuffer_get(&test_heap_handoff, &ptr))
+    {
+        easy_heap_free(ptr);
+    }
+    ASSERT(easy_heap_check_empty());
+    ASSERT(easy_heap_get_remain_size() == remain);
+
+    // every thread got a cache, the shared heap was not used
+    easy_heap_get_stats(&stats);
+    ASSERT(stats.xNumberOfSuccessfulAllocations == shared_allocs);
+
+    easy_heap_thread_cache_release();
+    easy_tools_api_heap_init(&port_heap);
+    easy_heap_init(port_heap.buf, port_heap.len);
+    ASSERT(easy_heap_check_empty());
+
+    SUITE_END();
+}
+#endif
+
+static void test_slab_work(void)
+{
+    SUITE_START("test_slab_work");
+
+    struct easy_slab_stats stats;
+    uint32_t remain_size = easy_heap_get_remain_size();
+    int class_cnt = easy_slab_get_class_count();
+    uint8_t *ptr[TEST_ALLOC_CNT];
+
+    ASSERT(class_cnt > 0);
+    ASSERT(easy_slab_check_empty());
+    ASSERT(easy_slab_get_stats(0, &stats) == 0);
+    ASSERT(stats.item_size > 0);
+    uint32_t small_size = stats.item_size;
+    ASSERT(easy_slab_get_stats(class_cnt + 1, &stats) == -1);
+
+    // first allocation of a class carves a page, the others hit the free list
+    for (int i = 0; i < TEST_ALLOC_CNT; i++)
+    {
+        ptr[i] = easy_slab_malloc(small_size);
+        ASSERT(ptr[i] != NULL);
+        memset(ptr[i], i, small_size);
+    }
+    ASSERT(easy_slab_get_stats(0, &stats) == 0);
+    ASSERT(stats.in_use == TEST_ALLOC_CNT);
+    ASSERT(stats.alloc_hits + stats.alloc_refills == TEST_ALLOC_CNT);
+    ASSERT(stats.alloc_refills == stats.pages);
+    ASSERT(stats.alloc_hits > 0);
+    for (int i = 0; i < TEST_ALLOC_CNT; i++)
+    {
+        for (uint32_t j = 0; j < small_size; j++)
+        {
+            ASSERT(ptr[i][j] == (uint8_t)i);
+        }
+    }
+
+    // freed object is reused by the next allocation of the same class
+    easy_slab_free(ptr[3], small_size);
+    ASSERT(easy_slab_malloc(small_size) == ptr[3]);
+
+    // large size falls through to the heap
+    void *large = easy_slab_malloc(remain_size / 4);
+    ASSERT(large != NULL);
+    ASSERT(easy_slab_get_stats(class_cnt, &stats) == 0);
+    ASSERT(stats.in_use == 1);
+    easy_slab_free(large, remain_size / 4);
+
+    for (int i = 0; i < TEST_ALLOC_CNT; i++)
+    {
+        easy_slab_free(ptr[i], small_size);
+    }
+    ASSERT(easy_slab_check_empty());
+    ASSERT(!easy_heap_check_empty());
+
+    easy_slab_reclaim();
+    ASSERT(easy_heap_check_empty());
+    ASSERT(easy_heap_get_remain_size() == remain_size);
+
+    SUITE_END();
+}
+
+void test_heap(void)
+{
+    test_heap_work();
+    test_heap_work_full();
+    test_heap_work_merge();
+    test_heap_work_invalid();
+    test_heap_work_instance();
+    test_heap_work_realloc();
+    test_heap_work_aligned();
+    test_heap_work_stats();
+    test_heap_work_bounded();
+    test_heap_work_bump();
+#if !EASY_CONFIG_HEAP_TLSF
+    test_heap_work_policy();
+#endif
+#if EASY_CONFIG_HEAP_DEFERRED_FREE
+    test_heap_work_deferred();
+#endif
+#if EASY_CONFIG_HEAP_THREAD_CACHE
+    test_heap_work_thread_cache();
+#endif
+    test_slab_work();
+}
+#else
+void test_heap(void)
+{
+}
+#endif
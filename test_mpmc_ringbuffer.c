@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+#define TEST_BUFFER_SIZE 256
+
+struct test_user_data
+{
+    uint32_t seq;
+    uint8_t data[13];
+};
+
+static void test_mpmc_work(void)
+{
+    SUITE_START("test_mpmc_work");
+
+    easy_mpmc_ringbuffer_t test_ringbuf;
+    static uint8_t test_buffer[TEST_BUFFER_SIZE * EASY_MPMC_RINGBUFFER_SLOT_SIZE(sizeof(struct test_user_data))] __EASY_ALIGNED__(4);
+
+    ASSERT(easy_mpmc_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE - 1, sizeof(struct test_user_data), test_buffer) == -1);
+    ASSERT(easy_mpmc_ringbuffer_init(&test_ringbuf, 0, sizeof(struct test_user_data), test_buffer) == -1);
+    ASSERT(easy_mpmc_ringbuffer_init(&test_ringbuf, 1, sizeof(struct test_user_data), test_buffer) == -1);
+    ASSERT(easy_mpmc_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, sizeof(struct test_user_data), test_buffer) == 0);
+
+    ASSERT(easy_mpmc_ringbuffer_total_size(&test_ringbuf) == TEST_BUFFER_SIZE);
+    ASSERT(easy_mpmc_ringbuffer_item_size(&test_ringbuf) == sizeof(struct test_user_data));
+    ASSERT(easy_mpmc_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_mpmc_ringbuffer_reserve_size(&test_ringbuf) == TEST_BUFFER_SIZE);
+    ASSERT(easy_mpmc_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_mpmc_ringbuffer_is_full(&test_ringbuf) == 0);
+
+    uint32_t seq = 0;
+    uint32_t expect = 0;
+    for (int test_cnt = 0; test_cnt < 0x100; test_cnt++)
+    {
+        struct test_user_data data;
+
+        // fill it up, then drain a varying part of it
+        while (easy_mpmc_ringbuffer_reserve_size(&test_ringbuf) > 0)
+        {
+            data.seq = seq;
+            memset(data.data, (uint8_t)seq, sizeof(data.data));
+            seq++;
+            ASSERT(easy_mpmc_ringbuffer_put(&test_ringbuf, &data) == 1);
+        }
+        ASSERT(easy_mpmc_ringbuffer_is_full(&test_ringbuf) == 1);
+        ASSERT(easy_mpmc_ringbuffer_put(&test_ringbuf, &data) == 0);
+
+        for (int i = 0; i <= test_cnt % TEST_BUFFER_SIZE; i++)
+        {
+            ASSERT(easy_mpmc_ringbuffer_get(&test_ringbuf, &data) == 1);
+            ASSERT(data.seq == expect);
+            ASSERT(data.data[0] == (uint8_t)expect && data.data[12] == (uint8_t)expect);
+            expect++;
+        }
+        ASSERT(easy_mpmc_ringbuffer_size(&test_ringbuf) == seq - expect);
+    }
+
+    while (easy_mpmc_ringbuffer_get(&test_ringbuf, NULL))
+    {
+        expect++;
+    }
+    ASSERT(expect == seq);
+    ASSERT(easy_mpmc_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    SUITE_END();
+}
+
+static void test_mpmc_work_enqueue_dequeue(void)
+{
+    SUITE_START("test_mpmc_work_enqueue_dequeue");
+
+    EASY_MPMC_RINGBUFFER_DEFINE(test_ringbuf, 4, sizeof(uint32_t));
+    ASSERT(EASY_MPMC_RINGBUFFER_INIT(test_ringbuf, 4, sizeof(uint32_t)) == 0);
+
+    void *mem[5];
+    uint32_t index[5];
+    uint32_t *item;
+    uint32_t item_index;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        index[i] = easy_mpmc_ringbuffer_enqueue_get(&test_ringbuf, &mem[i]);
+        ASSERT(mem[i] != NULL);
+        ASSERT(index[i] == i);
+        *(uint32_t *)mem[i] = i;
+    }
+    easy_mpmc_ringbuffer_enqueue_get(&test_ringbuf, &mem[4]);
+    ASSERT(mem[4] == NULL);
+
+    // claimed but not published, the consumer waits for slot 0
+    ASSERT(easy_mpmc_ringbuffer_size(&test_ringbuf) == 4);
+    easy_mpmc_ringbuffer_enqueue(&test_ringbuf, index[1]);
+    ASSERT(easy_mpmc_ringbuffer_dequeue_peek(&test_ringbuf, &item_index) == NULL);
+    easy_mpmc_ringbuffer_enqueue(&test_ringbuf, index[0]);
+
+    item = easy_mpmc_ringbuffer_dequeue_peek(&test_ringbuf, &item_index);
+    ASSERT(item != NULL && *item == 0 && item_index == 0);
+    item = easy_mpmc_ringbuffer_dequeue_peek(&test_ringbuf, &item_index);
+    ASSERT(item != NULL && *item == 1 && item_index == 1);
+    ASSERT(easy_mpmc_ringbuffer_dequeue_peek(&test_ringbuf, &item_index) == NULL);
+
+    // the slots are not free until they are given back
+    easy_mpmc_ringbuffer_enqueue_get(&test_ringbuf, &mem[4]);
+    ASSERT(mem[4] == NULL);
+    easy_mpmc_ringbuffer_dequeue(&test_ringbuf, 0);
+    index[4] = easy_mpmc_ringbuffer_enqueue_get(&test_ringbuf, &mem[4]);
+    ASSERT(mem[4] == mem[0] && index[4] == 4);
+    *(uint32_t *)mem[4] = 4;
+    easy_mpmc_ringbuffer_enqueue(&test_ringbuf, index[4]);
+    easy_mpmc_ringbuffer_dequeue(&test_ringbuf, 1);
+
+    easy_mpmc_ringbuffer_enqueue(&test_ringbuf, index[2]);
+    easy_mpmc_ringbuffer_enqueue(&test_ringbuf, index[3]);
+    for (uint32_t i = 2; i <= 4; i++)
+    {
+        uint32_t data;
+        ASSERT(easy_mpmc_ringbuffer_get(&test_ringbuf, &data) == 1);
+        ASSERT(data == i);
+    }
+    ASSERT(easy_mpmc_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    SUITE_END();
+}
+
+void test_mpmc_ringbuffer(void)
+{
+    test_mpmc_work();
+    test_mpmc_work_enqueue_dequeue();
+}
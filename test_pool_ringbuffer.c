@@ -56,6 +56,13 @@ struct test_user_data
 
 #define TEST_BUFFER_SIZE 256
 
+// a free item holds the free list link in intrusive mode
+#if EASY_CONFIG_POOL_INTRUSIVE
+#define TEST_POOL_LINK_SIZE ((int)sizeof(void *))
+#else
+#define TEST_POOL_LINK_SIZE 0
+#endif
+
 static void test_pool_work(void)
 {
     SUITE_START("test_pool_work");
@@ -173,7 +180,7 @@ static void test_pool_work_full(void)
             for (int i = 0; i < TEST_USER_DATA_SIZE; i++)
             {
                 // Make sure origin data is zero, avoid data overflow
-                ASSERT(data->data[i] == 0);
+                ASSERT(i < TEST_POOL_LINK_SIZE || data->data[i] == 0);
                 data->data[i] = i + loop + test_cnt;
             }
             ptr_save[loop] = data;
@@ -336,7 +343,7 @@ static void test_pool_work_full_odd(void)
             for (int i = 0; i < TEST_USER_DATA_SIZE_ODD; i++)
             {
                 // Make sure origin data is zero, avoid data overflow
-                ASSERT(data->data[i] == 0);
+                ASSERT(i < TEST_POOL_LINK_SIZE || data->data[i] == 0);
                 data->data[i] = i + loop + test_cnt;
             }
             ptr_save[loop] = data;
@@ -376,6 +383,58 @@ static void test_pool_work_full_odd(void)
     SUITE_END();
 }
 
+#if EASY_CONFIG_POOL_INTRUSIVE
+static void test_pool_work_lifo(void)
+{
+    SUITE_START("test_pool_work_lifo");
+
+    // items smaller than a pointer still hold the free list
+    EASY_POOL_DEFINE(test_pool, TEST_BUFFER_SIZE_ODD, 1);
+
+    EASY_POOL_INIT(test_pool, TEST_BUFFER_SIZE_ODD, 1);
+
+    uint8_t *ptr_save[TEST_BUFFER_SIZE_ODD];
+    uint8_t *data;
+
+    ASSERT(sizeof(test_pool_data_storage) == TEST_BUFFER_SIZE_ODD * sizeof(void *));
+    ASSERT(EASY_POOL_IS_FULL(&test_pool) == 1);
+
+    for (int loop = 0; loop < TEST_BUFFER_SIZE_ODD; loop++)
+    {
+        ASSERT(EASY_POOL_DEQUEUE(&test_pool, ptr_save[loop]) == 1);
+        ASSERT(ptr_save[loop] == (uint8_t *)test_pool_data_storage[loop]);
+        *ptr_save[loop] = (uint8_t)loop;
+    }
+    ASSERT(EASY_POOL_IS_EMPTY(&test_pool) == 1);
+    ASSERT(EASY_POOL_DEQUEUE(&test_pool, data) == 0);
+
+    // the last freed item comes back first
+    for (int test_cnt = 0; test_cnt < 0x100; test_cnt++)
+    {
+        int loop = (test_cnt * 37) % TEST_BUFFER_SIZE_ODD;
+
+        EASY_POOL_ENQUEUE(&test_pool, ptr_save[loop]);
+        ASSERT(EASY_POOL_SIZE(&test_pool) == 1);
+        ASSERT(EASY_POOL_DEQUEUE(&test_pool, data) == 1);
+        ASSERT(data == ptr_save[loop]);
+    }
+
+    for (int loop = 0; loop < TEST_BUFFER_SIZE_ODD; loop++)
+    {
+        EASY_POOL_ENQUEUE(&test_pool, ptr_save[loop]);
+    }
+    ASSERT(EASY_POOL_IS_FULL(&test_pool) == 1);
+    for (int loop = TEST_BUFFER_SIZE_ODD - 1; loop >= 0; loop--)
+    {
+        ASSERT(EASY_POOL_DEQUEUE(&test_pool, data) == 1);
+        ASSERT(data == ptr_save[loop]);
+    }
+    ASSERT(EASY_POOL_RESERVE_SIZE(&test_pool) == TEST_BUFFER_SIZE_ODD);
+
+    SUITE_END();
+}
+#endif
+
 void test_pool_ringbuffer(void)
 {
     test_pool_work();
@@ -383,5 +442,9 @@ void test_pool_ringbuffer(void)
 
     test_pool_work_odd();
     test_pool_work_full_odd();
+
+#if EASY_CONFIG_POOL_INTRUSIVE
+    test_pool_work_lifo();
+#endif
 }
 #endif
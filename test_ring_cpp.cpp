@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_ring.hpp"
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+// put and get batches of every size so the indices wrap at every position
+template <uint32_t N>
+static void test_ring_cpp_wrap_size(void)
+{
+    static easy::ring<uint32_t, N> ring;
+    uint32_t in[N + 1];
+    uint32_t out[N + 1];
+    uint32_t wseq = 0;
+    uint32_t rseq = 0;
+
+    ring.reset();
+    ASSERT(ring.capacity() == N);
+    ASSERT(ring.empty() && ring.size() == 0 && ring.reserve_size() == N);
+
+    for (uint32_t i = 0; i < 8 * N * N; i++)
+    {
+        uint32_t n = i % (N + 2);
+
+        for (uint32_t j = 0; j < n && j < N + 1; j++)
+        {
+            in[j] = wseq + j;
+        }
+
+        uint32_t reserve = ring.reserve_size();
+        uint32_t put = ring.put_n(in, n);
+        ASSERT(put == EASY_MIN(n, reserve));
+        wseq += put;
+        ASSERT(ring.size() == wseq - rseq);
+        ASSERT(ring.full() == (ring.size() == N));
+
+        uint32_t got = ring.get_n(out, (i * 3) % (N + 2));
+        for (uint32_t j = 0; j < got; j++)
+        {
+            ASSERT(out[j] == rseq + j);
+        }
+        rseq += got;
+        ASSERT(ring.size() == wseq - rseq);
+    }
+
+    // single items
+    while (ring.put(wseq))
+    {
+        wseq++;
+    }
+    ASSERT(ring.full() && ring.size() == N);
+    ASSERT(*ring.front() == rseq);
+    ring.pop();
+    rseq++;
+
+    uint32_t item = 0;
+    while (ring.get(item))
+    {
+        ASSERT(item == rseq);
+        rseq++;
+    }
+    ASSERT(rseq == wseq);
+    ASSERT(ring.empty() && ring.front() == nullptr);
+    ring.pop();
+    ASSERT(ring.empty());
+}
+
+static void test_ring_cpp_work(void)
+{
+    SUITE_START("test_ring_cpp_work");
+
+    test_ring_cpp_wrap_size<1>();
+    test_ring_cpp_wrap_size<5>();
+    test_ring_cpp_wrap_size<7>();
+    test_ring_cpp_wrap_size<8>();
+    test_ring_cpp_wrap_size<16>();
+
+    SUITE_END();
+}
+
+// same byte stream as easy_ringbuffer, on a power of 2 and a mirrored size
+template <uint32_t N>
+static void test_ring_cpp_byte_size(void)
+{
+    static easy::byte_ring<N> ring;
+    uint8_t c_buffer[N];
+    easy_ringbuffer_t c_ring;
+    uint8_t in[N + 3];
+    uint8_t out[N + 3];
+    uint8_t c_out[N + 3];
+    uint8_t seq = 0;
+
+    ring.reset();
+    easy_ringbuffer_init(&c_ring, N, c_buffer);
+
+    for (uint32_t i = 0; i < 16 * N; i++)
+    {
+        uint32_t n = (i * 5) % (N + 3);
+
+        for (uint32_t j = 0; j < n; j++)
+        {
+            in[j] = seq++;
+        }
+
+        ASSERT(ring.put(in, n) == easy_ringbuffer_put(&c_ring, in, n));
+        ASSERT(ring.size() == easy_ringbuffer_size(&c_ring));
+
+        n = (i * 3) % (N + 3);
+        uint32_t got = ring.get(out, n);
+        ASSERT(got == easy_ringbuffer_get(&c_ring, c_out, n));
+        ASSERT(memcmp(out, c_out, got) == 0);
+    }
+}
+
+static void test_ring_cpp_work_byte(void)
+{
+    SUITE_START("test_ring_cpp_work_byte");
+
+    test_ring_cpp_byte_size<7>();
+    test_ring_cpp_byte_size<64>();
+    test_ring_cpp_byte_size<100>();
+
+    SUITE_END();
+}
+
+struct test_ring_cpp_obj
+{
+    static int alive;
+
+    uint32_t a;
+    uint64_t b;
+
+    test_ring_cpp_obj(uint32_t x, uint64_t y) : a(x), b(y)
+    {
+        alive++;
+    }
+
+    ~test_ring_cpp_obj()
+    {
+        alive--;
+    }
+};
+
+int test_ring_cpp_obj::alive = 0;
+
+static void test_ring_cpp_work_pool(void)
+{
+    SUITE_START("test_ring_cpp_work_pool");
+
+    static easy::pool<test_ring_cpp_obj, 4> pool;
+    test_ring_cpp_obj *items[4];
+
+    ASSERT(pool.capacity() == 4 && pool.available() == 4);
+
+    // raw storage, aligned and distinct, nullptr once empty
+    for (int i = 0; i < 4; i++)
+    {
+        items[i] = pool.alloc();
+        ASSERT(items[i] != nullptr);
+        ASSERT(((uintptr_t)items[i] & (alignof(test_ring_cpp_obj) - 1)) == 0);
+        for (int j = 0; j < i; j++)
+        {
+            ASSERT(items[i] != items[j]);
+        }
+    }
+    ASSERT(pool.available() == 0 && pool.alloc() == nullptr);
+
+    // FIFO reuse, like easy_pool
+    pool.free(items[2]);
+    pool.free(items[0]);
+    ASSERT(pool.available() == 2);
+    ASSERT(pool.alloc() == items[2]);
+    ASSERT(pool.alloc() == items[0]);
+    for (int i = 0; i < 4; i++)
+    {
+        pool.free(items[i]);
+    }
+    ASSERT(pool.available() == 4);
+
+    // create runs the constructor, destroy the destructor
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            items[i] = pool.create(i, (uint64_t)round << 32);
+            ASSERT(items[i] != nullptr);
+            ASSERT(items[i]->a == (uint32_t)i && items[i]->b == (uint64_t)round << 32);
+        }
+        ASSERT(test_ring_cpp_obj::alive == 4);
+        ASSERT(pool.create(0, 0) == nullptr);
+        ASSERT(test_ring_cpp_obj::alive == 4);
+
+        for (int i = 0; i < 4; i++)
+        {
+            pool.destroy(items[(i + round) % 4]);
+        }
+        ASSERT(test_ring_cpp_obj::alive == 0);
+        ASSERT(pool.available() == 4);
+    }
+
+    SUITE_END();
+}
+
+extern "C" void test_ring_cpp(void)
+{
+    test_ring_cpp_work();
+    test_ring_cpp_work_byte();
+    test_ring_cpp_work_pool();
+}
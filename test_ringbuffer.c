@@ -1,8 +1,21 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L /* nanosleep */
+#endif
+
 #include <stdio.h>
 #include <string.h>
 
 #include "easy_tools.h"
 
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+#include <unistd.h>
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+#include <pthread.h>
+#include <time.h>
+#endif
+
 //
 // Tests
 //
@@ -970,6 +983,551 @@ static void test_work_read_index_big_to_write_index_odd(void)
     SUITE_END();
 }
 
+#define TEST_BUFFER_SIZE_POW2 512
+static void test_work_full_pow2(void)
+{
+    SUITE_START("test_work_full_pow2");
+
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE_POW2];
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE_POW2, test_buffer);
+    ASSERT(test_ringbuf.mask == TEST_BUFFER_SIZE_POW2 - 1);
+    ASSERT(easy_ringbuffer_total_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_reserve_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2);
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == 0);
+
+    uint8_t data[TEST_BUFFER_SIZE_POW2] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE_POW2] = {0};
+    uint8_t wseq = 0;
+    uint8_t rseq = 0;
+    int total_size = 0;
+
+    // put and get different sizes, so the data wraps at every position
+    for (int i = 0; i < 0x10000; i++)
+    {
+        int put_size = EASY_MIN((i * 7) % (TEST_BUFFER_SIZE_POW2 + 1), TEST_BUFFER_SIZE_POW2 - total_size);
+        int get_size = (i * 13) % (TEST_BUFFER_SIZE_POW2 + 1);
+
+        for (int j = 0; j < put_size; j++)
+        {
+            data[j] = wseq++;
+        }
+
+        ASSERT(easy_ringbuffer_put(&test_ringbuf, data, put_size) == put_size);
+        total_size += put_size;
+        ASSERT(easy_ringbuffer_size(&test_ringbuf) == total_size);
+        ASSERT(easy_ringbuffer_reserve_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2 - total_size);
+        ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == (total_size == TEST_BUFFER_SIZE_POW2));
+
+        int len = easy_ringbuffer_get(&test_ringbuf, rdata, get_size);
+        ASSERT(len == EASY_MIN(get_size, total_size));
+        for (int j = 0; j < len; j++)
+        {
+            ASSERT(rdata[j] == rseq++);
+        }
+
+        total_size -= len;
+        ASSERT(easy_ringbuffer_size(&test_ringbuf) == total_size);
+        ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == (total_size == 0));
+    }
+
+    SUITE_END();
+}
+
+static void test_work_full_define_pow2(void)
+{
+    SUITE_START("test_work_full_define_pow2");
+
+    EASY_RINGBUFFER_DEFINE(test_ringbuf, TEST_BUFFER_SIZE_POW2);
+
+    ASSERT(test_ringbuf.mask == TEST_BUFFER_SIZE_POW2 - 1);
+    ASSERT(easy_ringbuffer_total_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    uint8_t data[TEST_BUFFER_SIZE_POW2] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE_POW2] = {0};
+
+    for (int i = 0; i < 0x10000; i++)
+    {
+        int total_size = i % (TEST_BUFFER_SIZE_POW2 + 1);
+
+        for (int j = 0; j < total_size; j++)
+        {
+            data[j] = i;
+        }
+
+        ASSERT(easy_ringbuffer_put(&test_ringbuf, data, total_size) == total_size);
+        ASSERT(easy_ringbuffer_size(&test_ringbuf) == total_size);
+        ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == (total_size == TEST_BUFFER_SIZE_POW2));
+
+        int len = easy_ringbuffer_get(&test_ringbuf, rdata, sizeof(rdata));
+        for (int j = 0; j < total_size; j++)
+        {
+            ASSERT(rdata[j] == (uint8_t)i);
+        }
+
+        ASSERT(len == total_size);
+        ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+    }
+
+    SUITE_END();
+}
+
+static void test_work_index_wrap_pow2(void)
+{
+    SUITE_START("test_work_index_wrap_pow2");
+
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE_POW2];
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE_POW2, test_buffer);
+
+    // free running indices just before they overflow
+    test_ringbuf.read_index = 0xFFFFFF00;
+    test_ringbuf.write_index = 0xFFFFFF00;
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    uint8_t data[TEST_BUFFER_SIZE_POW2] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE_POW2] = {0};
+
+    for (int i = 0; i < TEST_BUFFER_SIZE_POW2; i++)
+    {
+        data[i] = i;
+    }
+
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE_POW2) == TEST_BUFFER_SIZE_POW2);
+    ASSERT(test_ringbuf.write_index < test_ringbuf.read_index);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2);
+    ASSERT(easy_ringbuffer_reserve_size(&test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == 1);
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, 1) == 0);
+
+    uint32_t len = easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE_POW2 / 2);
+    ASSERT(len == TEST_BUFFER_SIZE_POW2 / 2);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == TEST_BUFFER_SIZE_POW2 / 2);
+
+    len += easy_ringbuffer_get(&test_ringbuf, rdata + len, TEST_BUFFER_SIZE_POW2);
+    ASSERT(len == TEST_BUFFER_SIZE_POW2);
+    for (int i = 0; i < TEST_BUFFER_SIZE_POW2; i++)
+    {
+        ASSERT(rdata[i] == (uint8_t)i);
+    }
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    SUITE_END();
+}
+
+static void test_work_span_size(uint32_t buffer_size)
+{
+    easy_ringbuffer_t test_ringbuf;
+    easy_ringbuffer_span_t spans[2];
+    uint8_t test_buffer[TEST_BUFFER_SIZE_POW2];
+    uint8_t data[TEST_BUFFER_SIZE_POW2] = {0};
+    uint8_t *ptr;
+
+    easy_ringbuffer_init(&test_ringbuf, buffer_size, test_buffer);
+
+    // move the indices to the middle, so the spans wrap
+    uint32_t offset = buffer_size * 3 / 5;
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, offset) == offset);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, data, offset) == offset);
+
+    ASSERT(easy_ringbuffer_read_acquire_spans(&test_ringbuf, spans, buffer_size) == 0);
+    ASSERT(spans[0].len == 0 && spans[1].len == 0);
+
+    ASSERT(easy_ringbuffer_write_acquire_spans(&test_ringbuf, spans, buffer_size + 1) == buffer_size);
+    ASSERT(spans[0].ptr == test_buffer + offset);
+    ASSERT(spans[0].len == buffer_size - offset);
+    ASSERT(spans[1].ptr == test_buffer);
+    ASSERT(spans[1].len == offset);
+
+    // fill in place
+    for (uint32_t i = 0; i < spans[0].len; i++)
+    {
+        spans[0].ptr[i] = (uint8_t)i;
+    }
+    for (uint32_t i = 0; i < spans[1].len; i++)
+    {
+        spans[1].ptr[i] = (uint8_t)(spans[0].len + i);
+    }
+
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_write_commit(&test_ringbuf, buffer_size + 1) == buffer_size);
+    ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == 1);
+    ASSERT(easy_ringbuffer_write_acquire(&test_ringbuf, &ptr, buffer_size) == 0);
+
+    // parse in place
+    ASSERT(easy_ringbuffer_read_acquire_spans(&test_ringbuf, spans, buffer_size) == buffer_size);
+    ASSERT(spans[0].ptr == test_buffer + offset);
+    ASSERT(spans[0].len == buffer_size - offset);
+    ASSERT(spans[1].len == offset);
+    for (uint32_t i = 0; i < buffer_size; i++)
+    {
+        uint8_t c = i < spans[0].len ? spans[0].ptr[i] : spans[1].ptr[i - spans[0].len];
+        ASSERT(c == (uint8_t)i);
+    }
+
+    // release part of it, the first span only goes up to the buffer end
+    ASSERT(easy_ringbuffer_read_release(&test_ringbuf, 10) == 10);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == buffer_size - 10);
+    ASSERT(easy_ringbuffer_read_acquire(&test_ringbuf, &ptr, buffer_size) == buffer_size - offset - 10);
+    ASSERT(ptr == test_buffer + offset + 10);
+    ASSERT(*ptr == 10);
+
+    // contiguous write space is the released part
+    ASSERT(easy_ringbuffer_write_acquire(&test_ringbuf, &ptr, buffer_size) == 10);
+    ASSERT(ptr == test_buffer + offset);
+
+    // mixed with get
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, data, buffer_size) == buffer_size - 10);
+    for (uint32_t i = 0; i < buffer_size - 10; i++)
+    {
+        ASSERT(data[i] == (uint8_t)(i + 10));
+    }
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_ringbuffer_read_release(&test_ringbuf, 1) == 0);
+}
+
+static void test_work_span(void)
+{
+    SUITE_START("test_work_span");
+
+    test_work_span_size(TEST_BUFFER_SIZE);
+    test_work_span_size(TEST_BUFFER_SIZE_ODD);
+    test_work_span_size(TEST_BUFFER_SIZE_POW2);
+
+    SUITE_END();
+}
+
+static void test_work_overwrite_size(uint32_t buffer_size)
+{
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE_POW2];
+    uint8_t data[TEST_BUFFER_SIZE_POW2 * 2];
+    uint8_t rdata[TEST_BUFFER_SIZE_POW2];
+
+    easy_ringbuffer_init(&test_ringbuf, buffer_size, test_buffer);
+
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = i;
+    }
+
+    // room left, nothing dropped
+    ASSERT(easy_ringbuffer_put_overwrite(&test_ringbuf, data, buffer_size * 4 / 5) == buffer_size * 4 / 5);
+    ASSERT(easy_ringbuffer_take_dropped(&test_ringbuf) == 0);
+
+    // the oldest bytes make room for the new ones
+    ASSERT(easy_ringbuffer_put_overwrite(&test_ringbuf, data + buffer_size * 4 / 5, buffer_size / 2) == buffer_size / 2);
+    ASSERT(easy_ringbuffer_is_full(&test_ringbuf) == 1);
+    uint32_t dropped = buffer_size * 4 / 5 + buffer_size / 2 - buffer_size;
+    ASSERT(easy_ringbuffer_take_dropped(&test_ringbuf) == dropped);
+    ASSERT(easy_ringbuffer_take_dropped(&test_ringbuf) == 0);
+
+    ASSERT(easy_ringbuffer_get_overwrite(&test_ringbuf, rdata, buffer_size / 3) == buffer_size / 3);
+    ASSERT(memcmp(rdata, data + dropped, buffer_size / 3) == 0);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == buffer_size - buffer_size / 3);
+
+    // longer than the buffer, only the tail is kept
+    ASSERT(easy_ringbuffer_put_overwrite(&test_ringbuf, data, buffer_size + 10) == buffer_size);
+    ASSERT(easy_ringbuffer_take_dropped(&test_ringbuf) == 10 + buffer_size - buffer_size / 3);
+    ASSERT(easy_ringbuffer_get_overwrite(&test_ringbuf, rdata, sizeof(rdata)) == buffer_size);
+    ASSERT(memcmp(rdata, data + 10, buffer_size) == 0);
+    ASSERT(easy_ringbuffer_get_overwrite(&test_ringbuf, rdata, sizeof(rdata)) == 0);
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+}
+
+static void test_work_overwrite(void)
+{
+    SUITE_START("test_work_overwrite");
+
+    test_work_overwrite_size(TEST_BUFFER_SIZE);
+    test_work_overwrite_size(TEST_BUFFER_SIZE_ODD);
+    test_work_overwrite_size(TEST_BUFFER_SIZE_POW2);
+
+    SUITE_END();
+}
+
+static void test_work_find(void)
+{
+    SUITE_START("test_work_find");
+
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE];
+    uint8_t rdata[TEST_BUFFER_SIZE];
+    static const uint8_t sync[] = {0xEB, 0x90, 0xEB, 0x91};
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, test_buffer);
+    ASSERT(easy_ringbuffer_find(&test_ringbuf, '\n') == -1);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, sync, sizeof(sync)) == -1);
+
+    // the lines cross the end of the buffer
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, rdata, TEST_BUFFER_SIZE - 12) == TEST_BUFFER_SIZE - 12);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE - 12) == TEST_BUFFER_SIZE - 12);
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, (uint8_t *)"first line\nsecond\nthird", 23) == 23);
+
+    ASSERT(easy_ringbuffer_find(&test_ringbuf, '\n') == 10);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, 11) == 11);
+    ASSERT(memcmp(rdata, "first line\n", 11) == 0);
+
+    ASSERT(easy_ringbuffer_find(&test_ringbuf, '\n') == 6);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, 7) == 7);
+    ASSERT(memcmp(rdata, "second\n", 7) == 0);
+
+    // no full line yet
+    ASSERT(easy_ringbuffer_find(&test_ringbuf, '\n') == -1);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, (uint8_t *)"ird", 3) == 2);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, (uint8_t *)"irdx", 4) == -1);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, (uint8_t *)"third!", 6) == -1);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE) == 5);
+
+    // sync word across the end, after a partial match and with a partial match at the tail
+    easy_ringbuffer_reset(&test_ringbuf);
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, rdata, TEST_BUFFER_SIZE - 6) == TEST_BUFFER_SIZE - 6);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE - 6) == TEST_BUFFER_SIZE - 6);
+    static const uint8_t stream[] = {0x00, 0xEB, 0x90, 0xEB, 0x90, 0xEB, 0x91, 0x55, 0xEB, 0x90, 0xEB};
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, (uint8_t *)stream, sizeof(stream)) == sizeof(stream));
+
+    ASSERT(easy_ringbuffer_find(&test_ringbuf, 0x55) == 7);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, sync, sizeof(sync)) == 3);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, sync, 1) == 1);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, sync, 0) == 0);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, 4) == 4);
+    ASSERT(easy_ringbuffer_find_pattern(&test_ringbuf, sync, sizeof(sync)) == -1);
+
+    SUITE_END();
+}
+
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+static int test_watermark_high;
+static int test_watermark_low;
+
+static void test_watermark_callback(easy_ringbuffer_t *ringbuf, int high)
+{
+    ASSERT(ringbuf->user_data == &test_watermark_high);
+    if (high)
+    {
+        test_watermark_high++;
+    }
+    else
+    {
+        test_watermark_low++;
+    }
+}
+
+static void test_work_watermark(void)
+{
+    SUITE_START("test_work_watermark");
+
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE];
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    uint8_t *ptr;
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, test_buffer);
+    easy_ringbuffer_set_watermark(&test_ringbuf, 300, 100, test_watermark_callback, &test_watermark_high);
+
+    // below high, then crossing it once
+    easy_ringbuffer_put(&test_ringbuf, data, 200);
+    ASSERT(test_watermark_high == 0);
+    easy_ringbuffer_put(&test_ringbuf, data, 100);
+    ASSERT(test_watermark_high == 1);
+    easy_ringbuffer_put(&test_ringbuf, data, 100);
+    ASSERT(test_watermark_high == 1);
+
+    // falling to low once
+    easy_ringbuffer_get(&test_ringbuf, data, 250);
+    ASSERT(test_watermark_low == 0);
+    ASSERT(easy_ringbuffer_read_acquire(&test_ringbuf, &ptr, 50) == 50);
+    easy_ringbuffer_read_release(&test_ringbuf, 50);
+    ASSERT(test_watermark_low == 1);
+    easy_ringbuffer_get(&test_ringbuf, data, 100);
+    ASSERT(test_watermark_low == 1);
+
+    // zero-copy commit counts too
+    easy_ringbuffer_span_t spans[2];
+    ASSERT(easy_ringbuffer_write_acquire_spans(&test_ringbuf, spans, 300) == 300);
+    easy_ringbuffer_write_commit(&test_ringbuf, 300);
+    ASSERT(test_watermark_high == 2);
+
+    // off
+    easy_ringbuffer_set_watermark(&test_ringbuf, EASY_RINGBUFFER_WATERMARK_OFF, EASY_RINGBUFFER_WATERMARK_OFF, test_watermark_callback,
+                                  &test_watermark_high);
+    easy_ringbuffer_get(&test_ringbuf, data, TEST_BUFFER_SIZE);
+    easy_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE);
+    ASSERT(test_watermark_high == 2 && test_watermark_low == 1);
+
+    SUITE_END();
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_WAIT
+static void *test_wait_writer(void *arg)
+{
+    easy_ringbuffer_t *ringbuf = arg;
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    struct timespec delay = {0, 20 * 1000 * 1000};
+
+    // in two parts, the reader wants both
+    nanosleep(&delay, NULL);
+    easy_ringbuffer_put(ringbuf, data, 100);
+    nanosleep(&delay, NULL);
+    easy_ringbuffer_put(ringbuf, data, 100);
+
+    // wait for the reader to make room
+    easy_ringbuffer_wait_writable(ringbuf, TEST_BUFFER_SIZE, EASY_RINGBUFFER_WAIT_FOREVER);
+
+    return NULL;
+}
+
+static void test_work_wait(void)
+{
+    SUITE_START("test_work_wait");
+
+    easy_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE];
+    uint8_t data[TEST_BUFFER_SIZE];
+    pthread_t writer;
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, test_buffer);
+
+    ASSERT(easy_ringbuffer_wait_writable(&test_ringbuf, TEST_BUFFER_SIZE, 0) == 0);
+    ASSERT(easy_ringbuffer_wait_readable(&test_ringbuf, 1, 0) == -1);
+    ASSERT(easy_ringbuffer_wait_readable(&test_ringbuf, 1, 10) == -1);
+
+    ASSERT(pthread_create(&writer, NULL, test_wait_writer, &test_ringbuf) == 0);
+    ASSERT(easy_ringbuffer_wait_readable(&test_ringbuf, 200, EASY_RINGBUFFER_WAIT_FOREVER) == 0);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == 200);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, data, TEST_BUFFER_SIZE) == 200);
+    ASSERT(pthread_join(writer, NULL) == 0);
+    ASSERT(test_ringbuf.read_waiters == 0 && test_ringbuf.write_waiters == 0);
+
+    SUITE_END();
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+static void test_work_mirrored(void)
+{
+    SUITE_START("test_work_mirrored");
+
+    easy_ringbuffer_t test_ringbuf;
+    easy_ringbuffer_span_t spans[2];
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE] = {0};
+    uint8_t *ptr;
+
+    ASSERT(easy_ringbuffer_init_mirrored(&test_ringbuf, TEST_BUFFER_SIZE) == 0);
+
+    // rounded up to pages, so the power of 2 mode is used too
+    uint32_t total_size = easy_ringbuffer_total_size(&test_ringbuf);
+    ASSERT(total_size >= TEST_BUFFER_SIZE);
+    ASSERT(test_ringbuf.mask == total_size - 1);
+
+    // both mappings see the same memory
+    test_ringbuf.buffer[0] = 0x5A;
+    ASSERT(test_ringbuf.buffer[total_size] == 0x5A);
+    test_ringbuf.buffer[total_size + 1] = 0xA5;
+    ASSERT(test_ringbuf.buffer[1] == 0xA5);
+
+    for (int i = 0; i < TEST_BUFFER_SIZE; i++)
+    {
+        data[i] = i;
+    }
+
+    // move the indices close to the end
+    uint32_t offset = total_size - TEST_BUFFER_SIZE / 2;
+    for (uint32_t done = 0; done < offset; done += easy_ringbuffer_get(&test_ringbuf, rdata, sizeof(rdata)))
+    {
+        easy_ringbuffer_put(&test_ringbuf, data, EASY_MIN(sizeof(data), offset - done));
+    }
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    // the write window crosses the end, but it is one span
+    ASSERT(easy_ringbuffer_write_acquire_spans(&test_ringbuf, spans, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE);
+    ASSERT(spans[0].ptr == test_ringbuf.buffer + offset);
+    ASSERT(spans[0].len == TEST_BUFFER_SIZE);
+    ASSERT(spans[1].len == 0);
+    memcpy(spans[0].ptr, data, TEST_BUFFER_SIZE);
+    ASSERT(easy_ringbuffer_write_commit(&test_ringbuf, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE);
+
+    // the wrapped part is at the buffer start
+    ASSERT(test_ringbuf.buffer[0] == (uint8_t)(TEST_BUFFER_SIZE / 2));
+
+    ASSERT(easy_ringbuffer_read_acquire(&test_ringbuf, &ptr, total_size) == TEST_BUFFER_SIZE);
+    ASSERT(memcmp(ptr, data, TEST_BUFFER_SIZE) == 0);
+    ASSERT(easy_ringbuffer_read_release(&test_ringbuf, TEST_BUFFER_SIZE / 4) == TEST_BUFFER_SIZE / 4);
+
+    // put and get wrap with a single copy
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE);
+    ASSERT(memcmp(rdata, data + TEST_BUFFER_SIZE / 4, TEST_BUFFER_SIZE - TEST_BUFFER_SIZE / 4) == 0);
+    ASSERT(memcmp(rdata + TEST_BUFFER_SIZE - TEST_BUFFER_SIZE / 4, data, TEST_BUFFER_SIZE / 4) == 0);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf) == TEST_BUFFER_SIZE - TEST_BUFFER_SIZE / 4);
+
+    easy_ringbuffer_deinit_mirrored(&test_ringbuf);
+    ASSERT(easy_ringbuffer_total_size(&test_ringbuf) == 0);
+
+    SUITE_END();
+}
+#endif
+
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+static void test_work_fd(void)
+{
+    SUITE_START("test_work_fd");
+
+    easy_ringbuffer_t test_ringbuf;
+    easy_ringbuffer_t test_ringbuf_in;
+    uint8_t test_buffer[TEST_BUFFER_SIZE];
+    uint8_t test_buffer_in[TEST_BUFFER_SIZE_ODD];
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE] = {0};
+    int fds[2];
+
+    ASSERT(pipe(fds) == 0);
+
+    easy_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, test_buffer);
+    easy_ringbuffer_init(&test_ringbuf_in, TEST_BUFFER_SIZE_ODD, test_buffer_in);
+    ASSERT(easy_ringbuffer_write_to_fd(&test_ringbuf, fds[1], TEST_BUFFER_SIZE) == 0);
+
+    for (int i = 0; i < TEST_BUFFER_SIZE; i++)
+    {
+        data[i] = i;
+    }
+
+    // wrapped data goes out with one writev
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE * 3 / 4) == TEST_BUFFER_SIZE * 3 / 4);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf, rdata, TEST_BUFFER_SIZE * 3 / 4) == TEST_BUFFER_SIZE * 3 / 4);
+    ASSERT(easy_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE / 2) == TEST_BUFFER_SIZE / 2);
+    ASSERT(easy_ringbuffer_write_to_fd(&test_ringbuf, fds[1], TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE / 2);
+    ASSERT(easy_ringbuffer_is_empty(&test_ringbuf) == 1);
+
+    // and comes in wrapped with one readv
+    ASSERT(easy_ringbuffer_put(&test_ringbuf_in, data, TEST_BUFFER_SIZE_ODD - 10) == TEST_BUFFER_SIZE_ODD - 10);
+    ASSERT(easy_ringbuffer_get(&test_ringbuf_in, rdata, TEST_BUFFER_SIZE_ODD - 10) == TEST_BUFFER_SIZE_ODD - 10);
+    ASSERT(easy_ringbuffer_read_from_fd(&test_ringbuf_in, fds[0], 100) == 100);
+    ASSERT(easy_ringbuffer_read_from_fd(&test_ringbuf_in, fds[0], TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE / 2 - 100);
+    ASSERT(easy_ringbuffer_size(&test_ringbuf_in) == TEST_BUFFER_SIZE / 2);
+
+    ASSERT(easy_ringbuffer_get(&test_ringbuf_in, rdata, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE / 2);
+    ASSERT(memcmp(rdata, data, TEST_BUFFER_SIZE / 2) == 0);
+
+    // end of file
+    close(fds[1]);
+    ASSERT(easy_ringbuffer_read_from_fd(&test_ringbuf_in, fds[0], TEST_BUFFER_SIZE) == 0);
+    close(fds[0]);
+    ASSERT(easy_ringbuffer_read_from_fd(&test_ringbuf_in, fds[0], TEST_BUFFER_SIZE) == -1);
+
+    SUITE_END();
+}
+#endif
+
 void test_ringbuffer(void)
 {
     test_work();
@@ -985,4 +1543,24 @@ void test_ringbuffer(void)
     test_work_invalid_odd();
     test_work_full_odd();
     test_work_read_index_big_to_write_index_odd();
+
+    test_work_full_pow2();
+    test_work_full_define_pow2();
+    test_work_index_wrap_pow2();
+
+    test_work_span();
+    test_work_overwrite();
+    test_work_find();
+#if EASY_CONFIG_RINGBUFFER_MIRRORED
+    test_work_mirrored();
+#endif
+#if EASY_CONFIG_RINGBUFFER_FD_IO
+    test_work_fd();
+#endif
+#if EASY_CONFIG_RINGBUFFER_WATERMARK
+    test_work_watermark();
+#endif
+#if EASY_CONFIG_RINGBUFFER_WAIT
+    test_work_wait();
+#endif
 }
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "easy_tools.h"
+
+//
+// Tests
+//
+static const char *suite_name;
+static char suite_pass;
+static int suites_run = 0, suites_failed = 0, suites_empty = 0;
+static int tests_in_suite = 0, tests_run = 0, tests_failed = 0;
+
+#define QUOTE(str) #str
+#define ASSERT(x)                                                                                                                                              \
+    {                                                                                                                                                          \
+        tests_run++;                                                                                                                                           \
+        tests_in_suite++;                                                                                                                                      \
+        if (!(x))                                                                                                                                              \
+        {                                                                                                                                                      \
+            EASY_LOG_INF("failed assert [%s:%i] %s\n", __FILE__, __LINE__, QUOTE(x));                                                                          \
+            suite_pass = 0;                                                                                                                                    \
+            tests_failed++;                                                                                                                                    \
+            while (1)                                                                                                                                          \
+                ;                                                                                                                                              \
+        }                                                                                                                                                      \
+    }
+
+static void SUITE_START(const char *name)
+{
+    suite_pass = 1;
+    suite_name = name;
+    suites_run++;
+    tests_in_suite = 0;
+}
+
+static void SUITE_END(void)
+{
+    EASY_LOG_INF("Testing %s ", suite_name);
+    size_t suite_i;
+    for (suite_i = strlen(suite_name); suite_i < 80 - 8 - 5; suite_i++)
+        EASY_LOG_INF(".");
+    EASY_LOG_INF("%s\n", suite_pass ? " pass" : " fail");
+    if (!suite_pass)
+        suites_failed++;
+    if (!tests_in_suite)
+        suites_empty++;
+}
+
+#define TEST_BUFFER_SIZE 500
+
+static void test_spsc_work(void)
+{
+    SUITE_START("test_spsc_work");
+
+    easy_spsc_ringbuffer_t test_ringbuf;
+    uint8_t test_buffer[TEST_BUFFER_SIZE];
+
+    easy_spsc_ringbuffer_init(&test_ringbuf, TEST_BUFFER_SIZE, test_buffer);
+
+    ASSERT(easy_spsc_ringbuffer_total_size(&test_ringbuf) == TEST_BUFFER_SIZE);
+    ASSERT(easy_spsc_ringbuffer_size(&test_ringbuf) == 0);
+    ASSERT(easy_spsc_ringbuffer_reserve_size(&test_ringbuf) == TEST_BUFFER_SIZE);
+    ASSERT(easy_spsc_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_spsc_ringbuffer_is_full(&test_ringbuf) == 0);
+
+    // the indices are on their own cache lines
+    ASSERT(offsetof(easy_spsc_ringbuffer_t, write_index) % EASY_CONFIG_CACHE_LINE_SIZE == 0);
+    ASSERT(offsetof(easy_spsc_ringbuffer_t, read_index) % EASY_CONFIG_CACHE_LINE_SIZE == 0);
+    ASSERT(offsetof(easy_spsc_ringbuffer_t, read_index) - offsetof(easy_spsc_ringbuffer_t, write_index) >= EASY_CONFIG_CACHE_LINE_SIZE);
+
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE] = {0};
+
+    for (int i = 0; i < TEST_BUFFER_SIZE; i++)
+    {
+        data[i] = i;
+    }
+
+    // fill up, the extra bytes are not taken
+    ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data, TEST_BUFFER_SIZE / 2) == TEST_BUFFER_SIZE / 2);
+    ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data + TEST_BUFFER_SIZE / 2, TEST_BUFFER_SIZE) == TEST_BUFFER_SIZE - TEST_BUFFER_SIZE / 2);
+    ASSERT(easy_spsc_ringbuffer_is_full(&test_ringbuf) == 1);
+    ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data, 1) == 0);
+
+    ASSERT(easy_spsc_ringbuffer_get(&test_ringbuf, rdata, 100) == 100);
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT(rdata[i] == (uint8_t)i);
+    }
+
+    // the producer only sees the new space after its cached index is refreshed
+    ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data, 50) == 50);
+    ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data + 50, 100) == 50);
+    ASSERT(easy_spsc_ringbuffer_is_full(&test_ringbuf) == 1);
+
+    // read across the end of the buffer
+    ASSERT(easy_spsc_ringbuffer_get(&test_ringbuf, rdata, sizeof(rdata)) == TEST_BUFFER_SIZE);
+    for (int i = 0; i < TEST_BUFFER_SIZE - 100; i++)
+    {
+        ASSERT(rdata[i] == (uint8_t)(i + 100));
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT(rdata[TEST_BUFFER_SIZE - 100 + i] == (uint8_t)i);
+    }
+    ASSERT(easy_spsc_ringbuffer_is_empty(&test_ringbuf) == 1);
+    ASSERT(easy_spsc_ringbuffer_get(&test_ringbuf, rdata, 1) == 0);
+
+    SUITE_END();
+}
+
+static void test_spsc_work_full_define(void)
+{
+    SUITE_START("test_spsc_work_full_define");
+
+    EASY_SPSC_RINGBUFFER_DEFINE(test_ringbuf, TEST_BUFFER_SIZE);
+
+    uint8_t data[TEST_BUFFER_SIZE] = {0};
+    uint8_t rdata[TEST_BUFFER_SIZE] = {0};
+
+    for (int i = 0; i < 0x10000; i++)
+    {
+        int total_size = i % TEST_BUFFER_SIZE;
+
+        for (int j = 0; j < total_size; j++)
+        {
+            data[j] = i;
+        }
+
+        ASSERT(easy_spsc_ringbuffer_put(&test_ringbuf, data, total_size) == total_size);
+        ASSERT(easy_spsc_ringbuffer_size(&test_ringbuf) == total_size);
+        ASSERT(easy_spsc_ringbuffer_reserve_size(&test_ringbuf) == TEST_BUFFER_SIZE - total_size);
+
+        int len = easy_spsc_ringbuffer_get(&test_ringbuf, rdata, sizeof(rdata));
+        for (int j = 0; j < total_size; j++)
+        {
+            ASSERT(rdata[j] == (uint8_t)i);
+        }
+
+        ASSERT(len == total_size);
+        ASSERT(easy_spsc_ringbuffer_is_empty(&test_ringbuf) == 1);
+    }
+
+    SUITE_END();
+}
+
+void test_spsc_ringbuffer(void)
+{
+    test_spsc_work();
+    test_spsc_work_full_define();
+}
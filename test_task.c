@@ -6,6 +6,7 @@
 #if EASY_CONFIG_FUNCTION_TASK
 struct easy_task user_task1;
 struct easy_task user_task2;
+struct easy_task user_task3;
 
 static int test_msg_consumed_user_task1 = 0;
 static int test_msg_consumed_user_task2 = 0;
@@ -106,12 +107,59 @@ void user_task2_test(void)
     easy_task_send_msg(p_task, msg);
 }
 
+#define TEST_POOL_MSG_NUM  4
+#define TEST_POOL_MSG_SIZE (sizeof(struct easy_msg) + 16)
+EASY_POOL_DEFINE(user_task3_pool, TEST_POOL_MSG_NUM, TEST_POOL_MSG_SIZE);
+static const struct easy_msg_allocator user_task3_allocator = {easy_pool_hook_alloc, easy_pool_hook_free, &user_task3_pool};
+
+int user_task3_func(struct easy_msg *msg)
+{
+    EASY_LOG_DBG("user_task3(), id: 0x%x, len: %d, from pool: %d\n", msg->id, msg->param_len, msg->allocator == &user_task3_allocator);
+
+    return EASY_TASK_HDL_CONSUMED;
+}
+
+void user_task3_test(void)
+{
+    struct easy_task *p_task = &user_task3;
+
+    EASY_POOL_INIT(user_task3_pool, TEST_POOL_MSG_NUM, TEST_POOL_MSG_SIZE);
+
+    p_task->func = user_task3_func;
+    easy_task_create(p_task);
+    easy_task_set_allocator(p_task, &user_task3_allocator);
+
+    uint8_t data[16];
+    for (int i = 0; i < sizeof(data); i++)
+    {
+        data[i] = i + 0x30;
+    }
+
+    // the message is too big for the pool.
+    if (easy_task_msg_alloc_len(p_task, 0x40, sizeof(data) + 1) != NULL)
+    {
+        EASY_LOG_DBG("Something Error!\n");
+    }
+
+    for (int i = 0; i < TEST_POOL_MSG_NUM; i++)
+    {
+        easy_task_send_msg(p_task, easy_task_msg_alloc(p_task, 0x30 + i, sizeof(data), data));
+    }
+
+    // the pool is empty.
+    if (easy_task_msg_alloc_len(p_task, 0x41, 0) != NULL)
+    {
+        EASY_LOG_DBG("Something Error!\n");
+    }
+}
+
 void test_task(void)
 {
-    EASY_LOG_INF("Heap Remain Size: 0x%x\n", easy_heap_get_remain_size());
+    EASY_LOG_INF("Heap Remain Size: 0x%lx\n", (unsigned long)easy_heap_get_remain_size());
 
     user_task1_test();
     user_task2_test();
+    user_task3_test();
 
     // Test task delete
     // easy_task_delete(&user_task1);
@@ -126,8 +174,12 @@ static int task_check_end(void)
     if (easy_task_check_empty())
     {
         EASY_LOG_DBG("Task End Work!\n");
-        EASY_LOG_DBG("Heap Remain Size: 0x%x\n", easy_heap_get_remain_size());
-        if (!easy_heap_check_empty())
+#if EASY_CONFIG_FUNCTION_MSG_SLAB
+        // slab pages are kept for reuse, give them back before check the heap.
+        easy_slab_reclaim();
+#endif
+        EASY_LOG_DBG("Heap Remain Size: 0x%lx\n", (unsigned long)easy_heap_get_remain_size());
+        if (!easy_heap_check_empty() || !EASY_POOL_IS_FULL(&user_task3_pool))
         {
             EASY_LOG_DBG("Something Error!\n");
         }